@@ -0,0 +1,65 @@
+#include "cli_options.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+
+bool CliOptions::parse(int argc, char* argv[], const std::vector<std::string>& names) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            help_ = true;
+            continue;
+        }
+        if (std::find(names.begin(), names.end(), arg) == names.end()) {
+            std::cerr << (arg.rfind("-", 0) == 0 ? "Unknown option " : "Unexpected argument ")
+                      << arg << std::endl;
+            return false;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Option " << arg << " needs a value" << std::endl;
+            return false;
+        }
+        values_[arg] = argv[++i];
+    }
+    return true;
+}
+
+std::string CliOptions::get(const std::string& name, const std::string& defaultVal) const {
+    auto it = values_.find(name);
+    return it == values_.end() ? defaultVal : it->second;
+}
+
+int64_t CliOptions::getInt(const std::string& name, int64_t defaultVal) const {
+    auto it = values_.find(name);
+    if (it == values_.end()) {
+        return defaultVal;
+    }
+    try {
+        size_t used = 0;
+        int64_t value = std::stoll(it->second, &used);
+        if (used == it->second.size()) {
+            return value;
+        }
+    } catch (const std::exception&) {
+        // reported below
+    }
+    throw std::invalid_argument(name + " expects an integer, got '" + it->second + "'");
+}
+
+double CliOptions::getDouble(const std::string& name, double defaultVal) const {
+    auto it = values_.find(name);
+    if (it == values_.end()) {
+        return defaultVal;
+    }
+    try {
+        size_t used = 0;
+        double value = std::stod(it->second, &used);
+        if (used == it->second.size()) {
+            return value;
+        }
+    } catch (const std::exception&) {
+        // reported below
+    }
+    throw std::invalid_argument(name + " expects a number, got '" + it->second + "'");
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * "--name value" command-line options for the benchmark and test tools. Every option takes
+ * exactly one value; --help / -h may appear on its own.
+ */
+class CliOptions {
+public:
+    /**
+     * Parse argv[1..]. Returns false, after printing why to stderr, on an option not in
+     * `names`, an option without a value or a stray argument.
+     */
+    bool parse(int argc, char* argv[], const std::vector<std::string>& names);
+
+    bool helpRequested() const { return help_; }
+    bool has(const std::string& name) const { return values_.count(name) > 0; }
+
+    std::string get(const std::string& name, const std::string& defaultVal) const;
+
+    /**
+     * Numeric value of an option. Throws std::invalid_argument naming the option if the
+     * value isn't a number.
+     */
+    int64_t getInt(const std::string& name, int64_t defaultVal) const;
+    double getDouble(const std::string& name, double defaultVal) const;
+
+private:
+    std::map<std::string, std::string> values_;
+    bool help_ = false;
+};
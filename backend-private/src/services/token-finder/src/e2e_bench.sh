@@ -0,0 +1,112 @@
+#!/usr/bin/env bash
+# End-to-end benchmark: runs the real token_finder main loop against mock_rpc_node and a
+# local Postgres, then prints the run's JSON report (blocks/s, pools/s, RPC calls per pool,
+# p50/p99 detection latency).
+#
+# Uses the same DB_* variables as token_finder; the benchmark database is reset first, so
+# never point it at a production database. Tunables (defaults in brackets):
+#   BLOCKS [20000] START_BLOCK [20000000] BLOCK_TIME_MS [0] POOLS_PER_BLOCK [0.05]
+#   LATENCY_MS [2] JITTER_MS [1] ERROR_RATE [0] RPC_ERROR_RATE [0] FIXTURES [] PORT [18545]
+#   REPORT [Build/bench_e2e.json] INSTANCES [1] TIMEOUT_S [600]
+#
+# INSTANCES > 1 runs that many token_finder processes in coordinated mode; each writes its
+# own report (REPORT with -<n> before .json) covering the share of the scan it did.
+#
+# Exits non-zero if the mock doesn't come up, or if a token_finder run fails or hasn't
+# reached the last block within TIMEOUT_S seconds.
+
+set -euo pipefail
+cd "$(dirname "$0")"
+
+BLOCKS=${BLOCKS:-20000}
+START_BLOCK=${START_BLOCK:-20000000}
+BLOCK_TIME_MS=${BLOCK_TIME_MS:-0}
+POOLS_PER_BLOCK=${POOLS_PER_BLOCK:-0.05}
+LATENCY_MS=${LATENCY_MS:-2}
+JITTER_MS=${JITTER_MS:-1}
+ERROR_RATE=${ERROR_RATE:-0}
+RPC_ERROR_RATE=${RPC_ERROR_RATE:-0}
+FIXTURES=${FIXTURES:-}
+PORT=${PORT:-18545}
+REPORT=${REPORT:-Build/bench_e2e.json}
+INSTANCES=${INSTANCES:-1}
+TIMEOUT_S=${TIMEOUT_S:-600}
+
+# The mode is chosen by INSTANCES alone, whatever the caller's environment says
+unset COORDINATED_MODE INSTANCE_ID
+
+export PGHOST=${DB_HOST:-127.0.0.1} PGPORT=${DB_PORT:-5432} PGDATABASE=${DB_NAME:-test_db}
+export PGUSER=${DB_USER:-test_user} PGPASSWORD=${DB_PASS:-test_pass}
+
+# Start from an empty sink with the checkpoint just before the synthetic chain
+psql -q -v ON_ERROR_STOP=1 <<SQL
+TRUNCATE liquidity_pools, scan_journal, pool_enrichment_queue, scan_work_units;
+INSERT INTO block_info (id, last_block_processed) VALUES (1, '$(printf '0x%x' $((START_BLOCK - 1)))')
+  ON CONFLICT (id) DO UPDATE SET last_block_processed = EXCLUDED.last_block_processed;
+SQL
+
+MOCK_ARGS=(--port "$PORT" --start-block "$START_BLOCK" --blocks "$BLOCKS" --block-time-ms "$BLOCK_TIME_MS"
+           --pools-per-block "$POOLS_PER_BLOCK" --latency-ms "$LATENCY_MS" --jitter-ms "$JITTER_MS"
+           --error-rate "$ERROR_RATE" --rpc-error-rate "$RPC_ERROR_RATE")
+if [ -n "$FIXTURES" ]; then
+    MOCK_ARGS+=(--fixtures "$FIXTURES")
+fi
+
+./Build/mock_rpc_node "${MOCK_ARGS[@]}" > Build/mock_rpc_node.log 2>&1 &
+MOCK_PID=$!
+PIDS=()
+trap 'kill $MOCK_PID "${PIDS[@]}" 2>/dev/null || true' EXIT
+
+# The mock prints its banner once it accepts connections
+for _ in $(seq 1 100); do
+    if grep -q "listening" Build/mock_rpc_node.log; then
+        break
+    fi
+    if ! kill -0 "$MOCK_PID" 2>/dev/null; then
+        echo "mock_rpc_node exited:" >&2
+        cat Build/mock_rpc_node.log >&2
+        exit 1
+    fi
+    sleep 0.1
+done
+if ! grep -q "listening" Build/mock_rpc_node.log; then
+    echo "mock_rpc_node not ready after 10s" >&2
+    exit 1
+fi
+
+export QUICKNODE_API_URL="http://127.0.0.1:$PORT/"
+export STOP_AT_BLOCK=$((START_BLOCK + BLOCKS - 1))
+export POLL_INTERVAL_MS=${POLL_INTERVAL_MS:-100}
+export RPC_BACKOFF_MS=${RPC_BACKOFF_MS:-10}
+
+if [ "$INSTANCES" -le 1 ]; then
+    if ! BENCH_REPORT="$REPORT" timeout "$TIMEOUT_S" ./Build/token_finder > Build/bench_e2e.log 2>&1; then
+        echo "token_finder failed or timed out after ${TIMEOUT_S}s, see Build/bench_e2e.log" >&2
+        exit 1
+    fi
+    cat "$REPORT"
+    exit 0
+fi
+
+# Coordinated instances stop once the shared watermark reaches STOP_AT_BLOCK
+unset FEED_SOCKET_PATH FEED_SHM_NAME INDEX_SOCKET_PATH
+for i in $(seq 1 "$INSTANCES"); do
+    COORDINATED_MODE=1 INSTANCE_ID="bench-$i" BENCH_REPORT="${REPORT%.json}-$i.json" \
+        timeout "$TIMEOUT_S" ./Build/token_finder > "Build/bench_e2e-$i.log" 2>&1 &
+    PIDS+=($!)
+done
+FAILED=0
+for i in $(seq 1 "$INSTANCES"); do
+    if ! wait "${PIDS[$((i - 1))]}"; then
+        echo "instance $i failed or timed out after ${TIMEOUT_S}s, see Build/bench_e2e-$i.log" >&2
+        FAILED=1
+    fi
+done
+if [ "$FAILED" -ne 0 ]; then
+    exit 1
+fi
+
+for i in $(seq 1 "$INSTANCES"); do
+    echo "instance $i:"
+    cat "${REPORT%.json}-$i.json"
+done
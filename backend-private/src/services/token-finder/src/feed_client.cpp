@@ -0,0 +1,183 @@
+// Minimal pool feed subscriber: prints each record with its publish-to-receive latency.
+//
+//   feed_client --socket /tmp/token_finder.feed [--from <sequence>]
+//   feed_client --shm /token_finder_feed [--from <sequence>]
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "cli_options.hpp"
+#include "pool_decoder.hpp"
+#include "pool_feed.hpp"
+#include "socket_io.hpp"
+
+static void printRecord(const PoolFeedRecord& rec) {
+    uint64_t now = feedClockNs();
+    double latencyUs = now > rec.publishedNs ? (now - rec.publishedNs) / 1000.0 : 0.0;
+    std::string dex = rec.dexId < DEXES.size() ? DEXES[rec.dexId].dexName : "?";
+    std::cout << "seq=" << rec.sequence
+              << " dex=" << dex
+              << " pool=" << addressToHex(rec.pool)
+              << " token0=" << addressToHex(rec.token0)
+              << " token1=" << addressToHex(rec.token1)
+              << " block=" << rec.blockNumber
+              << " latency_us=" << latencyUs << std::endl;
+}
+
+static int runSocket(const std::string& path, uint64_t from) {
+    int fd = connectUnixSocket(path);
+    if (fd < 0) {
+        std::cerr << "connect " << path << ": " << std::strerror(errno) << std::endl;
+        return 1;
+    }
+
+    PoolFeedHello hello;
+    if (!sendAll(fd, &from, sizeof(from)) || !recvAll(fd, &hello, sizeof(hello))) {
+        std::cerr << "handshake failed" << std::endl;
+        return 1;
+    }
+    std::cout << "stream=" << hello.streamId << " oldest=" << hello.oldestSequence << std::endl;
+
+    PoolFeedRecord rec;
+    while (recvAll(fd, &rec, sizeof(rec))) {
+        printRecord(rec);
+    }
+    std::cerr << "feed closed" << std::endl;
+    ::close(fd);
+    return 0;
+}
+
+struct MappedRing {
+    const PoolFeedShmHeader* header = nullptr;
+    size_t size = 0;
+    ino_t inode = 0;
+};
+
+// Map the ring currently published under `name`. Fails quietly while the producer is still
+// initialising it, so callers can retry.
+static bool mapRing(const std::string& name, MappedRing& ring, std::string& error) {
+    int fd = ::shm_open(name.c_str(), O_RDONLY, 0);
+    struct stat st;
+    if (fd < 0 || ::fstat(fd, &st) != 0) {
+        error = "shm_open " + name + ": " + std::strerror(errno);
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        return false;
+    }
+    if ((size_t)st.st_size < sizeof(PoolFeedShmHeader)) {
+        ::close(fd);
+        error = "not a pool feed ring: " + name;
+        return false;
+    }
+    void* p = ::mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED) {
+        error = "mmap " + name + ": " + std::strerror(errno);
+        return false;
+    }
+    auto* header = static_cast<const PoolFeedShmHeader*>(p);
+    if (header->magic != POOL_FEED_SHM_MAGIC || header->recordSize != sizeof(PoolFeedRecord)
+        || sizeof(PoolFeedShmHeader) + header->capacity * sizeof(PoolFeedShmSlot) > (size_t)st.st_size) {
+        ::munmap(p, (size_t)st.st_size);
+        error = "not a pool feed ring: " + name;
+        return false;
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    ring.header = header;
+    ring.size = (size_t)st.st_size;
+    ring.inode = st.st_ino;
+    return true;
+}
+
+// True if `name` now refers to a different ring than the mapped one, i.e. the producer
+// restarted and replaced it
+static bool ringReplaced(const std::string& name, const MappedRing& ring) {
+    int fd = ::shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    bool replaced = ::fstat(fd, &st) == 0 && st.st_ino != ring.inode;
+    ::close(fd);
+    return replaced;
+}
+
+static int runShm(const std::string& name, uint64_t from) {
+    MappedRing ring;
+    std::string error;
+    if (!mapRing(name, ring, error)) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+    std::cout << "stream=" << ring.header->streamId << " capacity=" << ring.header->capacity << std::endl;
+
+    uint64_t next = from ? from : ring.header->lastSequence.load(std::memory_order_acquire) + 1;
+    unsigned idlePolls = 0;
+    while (true) {
+        const PoolFeedShmHeader* header = ring.header;
+        uint64_t last = header->lastSequence.load(std::memory_order_acquire);
+        if (next > last) {
+            // Spin briefly for latency, then sleep so an idle feed doesn't pin a core
+            if (++idlePolls < 1000) {
+                std::this_thread::yield();
+                continue;
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+            // A restarted producer publishes a new ring under the same name, starting again
+            // at sequence 1. Check for it every ~50ms of idling.
+            if (idlePolls % 250 == 0 && ringReplaced(name, ring)) {
+                MappedRing fresh;
+                if (mapRing(name, fresh, error)) {
+                    ::munmap(const_cast<PoolFeedShmHeader*>(ring.header), ring.size);
+                    ring = fresh;
+                    next = 1;
+                    std::cerr << "stream restarted: stream=" << ring.header->streamId
+                              << " capacity=" << ring.header->capacity << std::endl;
+                }
+            }
+            continue;
+        }
+        idlePolls = 0;
+        if (last >= header->capacity && next <= last - header->capacity) {
+            std::cerr << "lapped: skipping " << next << ".." << (last - header->capacity) << std::endl;
+            next = last - header->capacity + 1;
+        }
+        PoolFeedRecord rec;
+        if (readShmRecord(header, next, rec)) {
+            printRecord(rec);
+            next++;
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    const std::string usage = std::string("Usage: ") + argv[0]
+        + " (--socket <path> | --shm <name>) [--from <sequence>]";
+    CliOptions opts;
+    bool ok = opts.parse(argc, argv, {"--socket", "--shm", "--from"});
+    if (ok && opts.helpRequested()) {
+        std::cout << usage << std::endl;
+        return 0;
+    }
+    std::string socketPath = opts.get("--socket", "");
+    std::string shmName = opts.get("--shm", "");
+    int64_t from = 0;
+    try {
+        from = opts.getInt("--from", 0);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        ok = false;
+    }
+    if (!ok || from < 0 || socketPath.empty() == shmName.empty()) {
+        std::cerr << usage << std::endl;
+        return 1;
+    }
+    return socketPath.empty() ? runShm(shmName, (uint64_t)from) : runSocket(socketPath, (uint64_t)from);
+}
@@ -0,0 +1,171 @@
+// Load-test client for the pool index socket: N connections issuing lookups for a fixed
+// duration, then reports QPS and latency percentiles.
+//
+//   index_loadtest --socket /tmp/token_finder.index --tokens tokens.txt
+//                  [--threads 8] [--seconds 10] [--pipeline 1] [--op pools|info]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include "cli_options.hpp"
+#include "pool_decoder.hpp"
+#include "pool_index.hpp"
+#include "socket_io.hpp"
+#include "stats.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+struct Address {
+    uint8_t bytes[20];
+};
+
+struct WorkerStats {
+    std::vector<double> latenciesUs;
+    uint64_t found = 0;
+    uint64_t notFound = 0;
+    bool failed = false;
+};
+
+static void runWorker(const std::string& socketPath, const std::vector<Address>& tokens, uint8_t op,
+                      int pipeline, Clock::time_point deadline, unsigned seed, WorkerStats& stats)
+{
+    int fd = connectUnixSocket(socketPath);
+    if (fd < 0) {
+        std::cerr << "connect " << socketPath << ": " << std::strerror(errno) << std::endl;
+        stats.failed = true;
+        return;
+    }
+
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<size_t> pick(0, tokens.size() - 1);
+    std::vector<char> request(21 * (size_t)pipeline);
+    std::vector<char> payload;
+
+    while (Clock::now() < deadline) {
+        for (int i = 0; i < pipeline; i++) {
+            request[21 * i] = (char)op;
+            std::memcpy(&request[21 * i + 1], tokens[pick(rng)].bytes, 20);
+        }
+        auto started = Clock::now();
+        if (!sendAll(fd, request.data(), request.size())) {
+            stats.failed = true;
+            break;
+        }
+        for (int i = 0; i < pipeline; i++) {
+            IndexResponseHeader header;
+            if (!recvAll(fd, &header, sizeof(header))) {
+                stats.failed = true;
+                break;
+            }
+            payload.resize(header.length);
+            if (header.length > 0 && !recvAll(fd, payload.data(), header.length)) {
+                stats.failed = true;
+                break;
+            }
+            if (header.status == INDEX_STATUS_OK) stats.found++;
+            else stats.notFound++;
+        }
+        if (stats.failed) {
+            break;
+        }
+        double us = std::chrono::duration<double, std::micro>(Clock::now() - started).count();
+        // One round trip answers `pipeline` requests
+        for (int i = 0; i < pipeline; i++) {
+            stats.latenciesUs.push_back(us);
+        }
+    }
+    ::close(fd);
+}
+
+int main(int argc, char* argv[]) {
+    const std::string usage = std::string("Usage: ") + argv[0]
+        + " --socket <path> [--tokens <file>] [--threads N] [--seconds N] [--pipeline N] [--op pools|info]";
+    CliOptions opts;
+    bool ok = opts.parse(argc, argv, {"--socket", "--tokens", "--threads", "--seconds", "--pipeline", "--op"});
+    if (ok && opts.helpRequested()) {
+        std::cout << usage << std::endl;
+        return 0;
+    }
+    std::string socketPath = opts.get("--socket", "");
+    std::string tokensFile = opts.get("--tokens", "");
+    std::string opName = opts.get("--op", "pools");
+    int threads = 8, seconds = 10, pipeline = 1;
+    try {
+        threads = (int)std::clamp<int64_t>(opts.getInt("--threads", 8), 1, 4096);
+        seconds = (int)std::clamp<int64_t>(opts.getInt("--seconds", 10), 1, 86400);
+        pipeline = (int)std::clamp<int64_t>(opts.getInt("--pipeline", 1), 1, 4096);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        ok = false;
+    }
+    if (!ok || socketPath.empty() || (opName != "pools" && opName != "info")) {
+        std::cerr << usage << std::endl;
+        return 1;
+    }
+    uint8_t op = (opName == "pools") ? INDEX_OP_POOLS_FOR_TOKEN : INDEX_OP_TOKEN_INFO;
+
+    // Token addresses to query, one 0x... per line; random (mostly missing) addresses otherwise
+    std::vector<Address> tokens;
+    if (!tokensFile.empty()) {
+        std::ifstream in(tokensFile);
+        std::string line;
+        while (std::getline(in, line)) {
+            Address a;
+            if (addressFromHex(line, a.bytes)) {
+                tokens.push_back(a);
+            }
+        }
+    }
+    if (tokens.empty()) {
+        std::mt19937 rng(42);
+        tokens.resize(10000);
+        for (auto& a : tokens) {
+            for (auto& b : a.bytes) b = (uint8_t)rng();
+        }
+        std::cerr << "No token file given, querying random addresses" << std::endl;
+    }
+
+    auto started = Clock::now();
+    auto deadline = started + std::chrono::seconds(seconds);
+    std::vector<WorkerStats> stats(threads);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back(runWorker, std::cref(socketPath), std::cref(tokens), op, pipeline,
+                             deadline, (unsigned)t + 1, std::ref(stats[t]));
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+    double elapsed = std::chrono::duration<double>(Clock::now() - started).count();
+
+    std::vector<double> all;
+    uint64_t found = 0, notFound = 0;
+    bool failed = false;
+    for (auto& s : stats) {
+        all.insert(all.end(), s.latenciesUs.begin(), s.latenciesUs.end());
+        found += s.found;
+        notFound += s.notFound;
+        failed |= s.failed;
+    }
+    std::sort(all.begin(), all.end());
+
+    std::cout << std::fixed << std::setprecision(1)
+              << "requests=" << all.size()
+              << " found=" << found
+              << " not_found=" << notFound
+              << " qps=" << (double)all.size() / elapsed
+              << " p50_us=" << percentileOfSorted(all, 0.50)
+              << " p99_us=" << percentileOfSorted(all, 0.99)
+              << " p999_us=" << percentileOfSorted(all, 0.999)
+              << " max_us=" << (all.empty() ? 0.0 : all.back()) << std::endl;
+    return failed ? 1 : 0;
+}
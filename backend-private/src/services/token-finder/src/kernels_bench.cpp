@@ -0,0 +1,293 @@
+// Microbenchmarks for the CPU-bound kernels: keccak256, hex/ABI decoding and V2/V3 log decoding.
+//
+//   kernels_bench [--filter <substring>] [--min-time-ms 200] [--json <out.json>]
+//                 [--baseline <previous.json>] [--max-regression 0.10]
+//
+// Every kernel is first checked against known answers, so a rewrite that changes results
+// fails before it is timed. Each kernel is then calibrated to run for at least min-time,
+// timed over 5 repetitions and reported as the median ns/op and input bytes/s. --json saves
+// the results; --baseline compares against a saved run and exits non-zero if any kernel is
+// slower by more than max-regression.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include "cli_options.hpp"
+#include "keccak.hpp"
+#include "pool_decoder.hpp"
+
+using json = nlohmann::json;
+using Clock = std::chrono::steady_clock;
+
+/**
+ * Keep the compiler from discarding a benchmarked result
+ */
+template <typename T>
+static inline void doNotOptimize(const T& value) {
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+struct Kernel {
+    std::string name;
+    size_t bytesPerOp;                 // input size, for bytes/s
+    std::function<void()> run;         // one operation
+};
+
+struct KernelResult {
+    std::string name;
+    double nsPerOp;
+    double bytesPerSecond;
+    uint64_t iterations;
+};
+
+static double timeIterations(const Kernel& k, uint64_t iterations) {
+    auto started = Clock::now();
+    for (uint64_t i = 0; i < iterations; i++) {
+        k.run();
+    }
+    return std::chrono::duration<double, std::nano>(Clock::now() - started).count();
+}
+
+static KernelResult measure(const Kernel& k, double minTimeNs) {
+    // Grow the iteration count until one repetition takes at least minTimeNs
+    uint64_t iterations = 1;
+    while (true) {
+        double ns = timeIterations(k, iterations);
+        if (ns >= minTimeNs || iterations >= (1ULL << 32)) {
+            break;
+        }
+        double scale = ns > 0 ? std::min(10.0, 1.4 * minTimeNs / ns) : 10.0;
+        iterations = std::max<uint64_t>(iterations + 1, (uint64_t)(iterations * scale));
+    }
+
+    std::vector<double> perOp;
+    for (int rep = 0; rep < 5; rep++) {
+        perOp.push_back(timeIterations(k, iterations) / (double)iterations);
+    }
+    std::sort(perOp.begin(), perOp.end());
+    double ns = perOp[perOp.size() / 2];
+    return {k.name, ns, k.bytesPerOp * 1e9 / ns, iterations};
+}
+
+static std::string pad32(const std::string& hexWord) {
+    return std::string(64 - hexWord.size(), '0') + hexWord;
+}
+
+/**
+ * ABI-encoded string as returned by symbol()/name()
+ */
+static std::string abiString(const std::string& s) {
+    static const char digits[] = "0123456789abcdef";
+    std::string data;
+    for (unsigned char c : s) {
+        data.push_back(digits[c >> 4]);
+        data.push_back(digits[c & 0x0f]);
+    }
+    data.resize(((data.size() + 63) / 64) * 64, '0');
+    std::ostringstream len;
+    len << std::hex << s.size();
+    return "0x" + pad32("20") + pad32(len.str()) + data;
+}
+
+// Realistic inputs: mainnet-shaped factory logs and token getter responses
+static const std::string WETH = "c02aaa39b223fe8d0a0e5c4f27ead9083c756cc2";
+static const std::string USDC = "a0b86991c6218b36c1d19d4a2e9eb0ce3606eb48";
+static const std::string POOL = "88e6a0c2ddd26feeb64f039a2c41296fcb3f5640";
+
+// Built on first use: V2_SIG/V3_SIG live in another translation unit
+static const json& v2Log() {
+    static const json log = {
+        {"address", "0x5c69bee701ef814a2b6a3edd4b1652cb9cc5aa6f"},
+        {"blockNumber", "0x1312d05"},
+        {"topics", {V2_SIG, "0x" + pad32(USDC), "0x" + pad32(WETH), "0x" + pad32(POOL)}},
+        {"data", "0x" + pad32("1b3d2")}
+    };
+    return log;
+}
+
+static const json& v3Log() {
+    static const json log = {
+        {"address", "0x1f98431c8ad98523631ae4a59f267346ea31f984"},
+        {"blockNumber", "0x1312d05"},
+        {"topics", {V3_SIG, "0x" + pad32(USDC), "0x" + pad32(WETH), "0x" + pad32("1f4")}},
+        {"data", "0x" + pad32("a") + pad32(POOL)}
+    };
+    return log;
+}
+
+static int failures = 0;
+
+static void expect(bool ok, const std::string& what) {
+    if (!ok) {
+        std::cerr << "KNOWN-ANSWER FAILURE: " << what << std::endl;
+        failures++;
+    }
+}
+
+/**
+ * Known-answer checks so a faster kernel can't silently change results
+ */
+static void checkKernels() {
+    expect(keccak256("") == "0xc5d2460186f7233c927e7db2dcc703c0e500b653ca82273b7bfad8045d85a470",
+           "keccak256(\"\")");
+    expect(V2_SIG == "0x0d3648bd0f6ba80134a33ba9275ac585d9d315f0ad8355cddefde31afa28d0e9", "V2_SIG");
+    expect(V3_SIG == "0x783cca1c0412dd0d695e784568c96da2e9c22ff989357a2e8b1d9b2b4e6b7118", "V3_SIG");
+    expect(decodeStringFromHex(abiString("USDC")) == "USDC", "decodeStringFromHex symbol");
+    expect(decodeStringFromHex("0x") == "", "decodeStringFromHex empty");
+    expect(topicToAddress("0x" + pad32(WETH)) == "0x" + WETH, "topicToAddress");
+    expect(decimalToHex(20000005) == "0x1312d05", "decimalToHex");
+
+    PoolRecord rec;
+    expect(decodePoolLog(DEXES[0], v2Log(), rec) && rec.poolAddress == "0x" + POOL
+           && rec.token0 == "0x" + USDC && rec.token1 == "0x" + WETH, "decodePoolLog V2");
+    expect(decodePoolLog(DEXES[2], v3Log(), rec) && rec.poolAddress == "0x" + POOL
+           && rec.fee == 500 && rec.tickSpacing == 10, "decodePoolLog V3");
+
+    json noBlock = v2Log();
+    noBlock.erase("blockNumber");
+    std::string error;
+    expect(!decodePoolLog(DEXES[0], noBlock, rec, &error) && !error.empty(),
+           "decodePoolLog rejects a log without blockNumber");
+}
+
+int main(int argc, char* argv[]) {
+    const std::string usage = std::string("Usage: ") + argv[0]
+        + " [--filter <substring>] [--min-time-ms 200] [--json <out.json>]"
+          " [--baseline <previous.json>] [--max-regression 0.10]";
+    CliOptions opts;
+    if (!opts.parse(argc, argv, {"--filter", "--min-time-ms", "--json", "--baseline", "--max-regression"})) {
+        std::cerr << usage << std::endl;
+        return 1;
+    }
+    if (opts.helpRequested()) {
+        std::cout << usage << std::endl;
+        return 0;
+    }
+    std::string filter = opts.get("--filter", "");
+    std::string jsonOut = opts.get("--json", "");
+    std::string baselinePath = opts.get("--baseline", "");
+    double minTimeMs, maxRegression;
+    try {
+        minTimeMs = opts.getDouble("--min-time-ms", 200);
+        maxRegression = opts.getDouble("--max-regression", 0.10);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n" << usage << std::endl;
+        return 1;
+    }
+
+    checkKernels();
+    if (failures > 0) {
+        return 2;
+    }
+
+    const std::string selectorSig = "PoolCreated(address,address,uint24,int24,address)";
+    const std::string block136(136, 'k');      // exactly one keccak rate block
+    const std::string block1k(1024, 'k');
+    const std::string symbolHex = abiString("WETH");
+    const std::string nameHex = abiString("Wrapped Ether Liquidity Provider Token Long Name");
+    const std::string topic = "0x" + pad32(WETH);
+    const json& v2 = v2Log();
+    const json& v3 = v3Log();
+    const std::string v2Text = v2.dump();
+    const std::string v3Text = v3.dump();
+    const std::string addressHex = "0x" + WETH;
+    int64_t blockNum = 20000005;
+
+    std::vector<Kernel> kernels = {
+        {"keccak256/event_signature", selectorSig.size(), [&] { doNotOptimize(keccak256(selectorSig)); }},
+        {"keccak256/136B", block136.size(), [&] { doNotOptimize(keccak256(block136)); }},
+        {"keccak256/1KiB", block1k.size(), [&] { doNotOptimize(keccak256(block1k)); }},
+        {"decodeStringFromHex/symbol", symbolHex.size(), [&] { doNotOptimize(decodeStringFromHex(symbolHex)); }},
+        {"decodeStringFromHex/name", nameHex.size(), [&] { doNotOptimize(decodeStringFromHex(nameHex)); }},
+        {"topicToAddress", topic.size(), [&] { doNotOptimize(topicToAddress(topic)); }},
+        {"decimalToHex", sizeof(blockNum), [&] { doNotOptimize(decimalToHex(blockNum)); }},
+        {"addressFromHex", addressHex.size(), [&] {
+            uint8_t out[20];
+            doNotOptimize(addressFromHex(addressHex, out));
+            doNotOptimize(out);
+        }},
+        {"decodePoolLog/v2", v2Text.size(), [&] {
+            PoolRecord rec;
+            doNotOptimize(decodePoolLog(DEXES[0], v2, rec));
+            doNotOptimize(rec);
+        }},
+        {"decodePoolLog/v3", v3Text.size(), [&] {
+            PoolRecord rec;
+            doNotOptimize(decodePoolLog(DEXES[2], v3, rec));
+            doNotOptimize(rec);
+        }},
+        {"parseAndDecodePoolLog/v3", v3Text.size(), [&] {
+            PoolRecord rec;
+            doNotOptimize(decodePoolLog(DEXES[2], json::parse(v3Text), rec));
+            doNotOptimize(rec);
+        }},
+    };
+
+    json baseline;
+    if (!baselinePath.empty()) {
+        std::ifstream in(baselinePath);
+        if (!in) {
+            std::cerr << "Cannot open baseline " << baselinePath << std::endl;
+            return 1;
+        }
+        try {
+            baseline = json::parse(in);
+        } catch (const std::exception& e) {
+            std::cerr << "Cannot parse baseline " << baselinePath << ": " << e.what() << std::endl;
+            return 1;
+        }
+        if (!baseline.is_object()) {
+            std::cerr << "Baseline " << baselinePath << " is not a kernels_bench --json file" << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << std::left << std::setw(30) << "kernel" << std::right
+              << std::setw(12) << "ns/op" << std::setw(12) << "MB/s" << std::setw(14) << "iterations";
+    if (!baseline.is_null()) {
+        std::cout << std::setw(14) << "base ns/op" << std::setw(10) << "speedup";
+    }
+    std::cout << std::endl;
+
+    json results = json::object();
+    bool regressed = false;
+    for (const auto& k : kernels) {
+        if (!filter.empty() && k.name.find(filter) == std::string::npos) {
+            continue;
+        }
+        KernelResult r = measure(k, minTimeMs * 1e6);
+        results[r.name] = {{"ns_per_op", r.nsPerOp}, {"bytes_per_s", r.bytesPerSecond}, {"iterations", r.iterations}};
+
+        std::cout << std::left << std::setw(30) << r.name << std::right << std::fixed
+                  << std::setw(12) << std::setprecision(1) << r.nsPerOp
+                  << std::setw(12) << std::setprecision(1) << r.bytesPerSecond / 1e6
+                  << std::setw(14) << r.iterations;
+        if (baseline.contains(r.name)) {
+            double baseNs = baseline[r.name]["ns_per_op"].get<double>();
+            double speedup = baseNs / r.nsPerOp;
+            bool slower = r.nsPerOp > baseNs * (1.0 + maxRegression);
+            regressed |= slower;
+            std::cout << std::setw(14) << std::setprecision(1) << baseNs
+                      << std::setw(9) << std::setprecision(2) << speedup << "x"
+                      << (slower ? "  REGRESSION" : "");
+        } else if (!baseline.is_null()) {
+            std::cout << std::setw(24) << "not in baseline";
+        }
+        std::cout << std::endl;
+    }
+
+    if (!jsonOut.empty()) {
+        std::ofstream out(jsonOut);
+        out << results.dump(2) << std::endl;
+    }
+    return regressed ? 3 : 0;
+}
@@ -0,0 +1,239 @@
+#include "log_ingest.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using json = nlohmann::json;
+
+/**
+ * Read-only mapping of a whole file, unmapped on destruction
+ */
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("Cannot open " + path + ": " + std::strerror(errno));
+        }
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            int err = errno;
+            ::close(fd);
+            throw std::runtime_error("Cannot stat " + path + ": " + std::strerror(err));
+        }
+        size_ = static_cast<size_t>(st.st_size);
+        if (size_ > 0) {
+            void* p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p == MAP_FAILED) {
+                int err = errno;
+                ::close(fd);
+                throw std::runtime_error("Cannot mmap " + path + ": " + std::strerror(err));
+            }
+            ::madvise(p, size_, MADV_SEQUENTIAL);
+            data_ = static_cast<const char*>(p);
+        }
+        ::close(fd);
+    }
+
+    ~MappedFile() {
+        if (data_) {
+            ::munmap(const_cast<char*>(data_), size_);
+        }
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    std::string_view view() const { return std::string_view(data_ ? data_ : "", size_); }
+
+private:
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+/**
+ * Pull a "0x..." quantity for `key` (e.g. "\"number\"") out of a JSON line without parsing it.
+ * Returns -1 if the key is absent or the value isn't a hex string.
+ */
+static int64_t extractHexField(std::string_view line, std::string_view key) {
+    size_t pos = line.find(key);
+    if (pos == std::string_view::npos) {
+        return -1;
+    }
+    pos = line.find('"', pos + key.size());
+    if (pos == std::string_view::npos || line.compare(pos + 1, 2, "0x") != 0) {
+        return -1;
+    }
+    int64_t value = 0;
+    bool any = false;
+    for (size_t i = pos + 3; i < line.size() && line[i] != '"'; i++) {
+        char c = line[i];
+        int digit;
+        if (c >= '0' && c <= '9')      digit = c - '0';
+        else if (c >= 'a' && c <= 'f') digit = c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F') digit = c - 'A' + 10;
+        else return -1;
+        value = (value << 4) | digit;
+        any = true;
+    }
+    return any ? value : -1;
+}
+
+static std::string toLower(std::string s) {
+    std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c) { return std::tolower(c); });
+    return s;
+}
+
+/**
+ * Per-worker output, merged once all workers finish
+ */
+struct IngestShard {
+    std::vector<PoolRecord> pools;
+    std::vector<std::pair<int64_t, int64_t>> blockTimestamps;
+    int64_t startBlock = -1;
+    int64_t endBlock = -1;
+    int64_t firstLogBlock = -1;
+    int64_t lastLogBlock = -1;
+    size_t linesScanned = 0;
+    size_t malformedLogs = 0;
+};
+
+/**
+ * Widen [lo, hi] to include block; -1 means empty
+ */
+static void widenRange(int64_t& lo, int64_t& hi, int64_t block) {
+    if (block < 0) {
+        return;
+    }
+    if (lo < 0 || block < lo) lo = block;
+    if (block > hi) hi = block;
+}
+
+/**
+ * Scan the lines that start inside [begin, end) of `data`
+ */
+static void scanSlice(std::string_view data, size_t begin, size_t end,
+                      const std::vector<std::string>& factories, IngestShard& shard)
+{
+    // A slice owns the lines that start inside it; skip the partial line a previous slice owns
+    size_t pos = begin;
+    if (pos > 0 && data[pos - 1] != '\n') {
+        size_t nl = data.find('\n', pos);
+        pos = (nl == std::string_view::npos) ? data.size() : nl + 1;
+    }
+
+    while (pos < end) {
+        size_t nl = data.find('\n', pos);
+        size_t lineEnd = (nl == std::string_view::npos) ? data.size() : nl;
+        std::string_view line = data.substr(pos, lineEnd - pos);
+        pos = lineEnd + 1;
+
+        if (line.empty()) {
+            continue;
+        }
+        shard.linesScanned++;
+
+        if (line.find("\"topics\"") == std::string_view::npos) {
+            // Block header
+            int64_t number = extractHexField(line, "\"number\"");
+            int64_t timestamp = extractHexField(line, "\"timestamp\"");
+            if (number >= 0 && timestamp >= 0) {
+                shard.blockTimestamps.emplace_back(number, timestamp);
+                widenRange(shard.startBlock, shard.endBlock, number);
+            }
+            continue;
+        }
+
+        widenRange(shard.firstLogBlock, shard.lastLogBlock, extractHexField(line, "\"blockNumber\""));
+
+        bool isV2 = line.find(V2_SIG) != std::string_view::npos;
+        bool isV3 = !isV2 && line.find(V3_SIG) != std::string_view::npos;
+        if (!isV2 && !isV3) {
+            continue;
+        }
+
+        json logEntry;
+        try {
+            logEntry = json::parse(line);
+        } catch (const std::exception&) {
+            shard.malformedLogs++;
+            continue;
+        }
+        if (!logEntry.contains("address") || !logEntry["address"].is_string()) {
+            shard.malformedLogs++;
+            continue;
+        }
+
+        std::string address = toLower(logEntry["address"].get<std::string>());
+        for (size_t i = 0; i < DEXES.size(); i++) {
+            if (address != factories[i] || DEXES[i].isV2Style != isV2) {
+                continue;
+            }
+            PoolRecord rec;
+            std::string error;
+            if (decodePoolLog(DEXES[i], logEntry, rec, &error)) {
+                shard.pools.push_back(std::move(rec));
+            } else if (!error.empty()) {
+                shard.malformedLogs++;
+            }
+            break;
+        }
+    }
+}
+
+IngestResult ingestLogDumps(const std::vector<std::string>& paths, unsigned threads) {
+    threads = std::max(1u, threads);
+
+    std::vector<std::string> factories;
+    for (const auto& dex : DEXES) {
+        factories.push_back(toLower(dex.factoryAddress));
+    }
+
+    IngestResult result;
+    for (const auto& path : paths) {
+        MappedFile file(path);
+        std::string_view data = file.view();
+        if (data.empty()) {
+            continue;
+        }
+
+        unsigned workers = static_cast<unsigned>(std::min<size_t>(threads, data.size()));
+        size_t sliceSize = (data.size() + workers - 1) / workers;
+        std::vector<IngestShard> shards(workers);
+        std::vector<std::thread> pool;
+        for (unsigned w = 0; w < workers; w++) {
+            size_t begin = std::min(data.size(), w * sliceSize);
+            size_t end = std::min(data.size(), begin + sliceSize);
+            pool.emplace_back(scanSlice, data, begin, end, std::cref(factories), std::ref(shards[w]));
+        }
+        for (auto& t : pool) {
+            t.join();
+        }
+
+        // Shards are in file order, so pools keep their on-disk order
+        for (auto& shard : shards) {
+            result.pools.insert(result.pools.end(),
+                                std::make_move_iterator(shard.pools.begin()),
+                                std::make_move_iterator(shard.pools.end()));
+            for (const auto& bt : shard.blockTimestamps) {
+                result.blockTimestamps[bt.first] = bt.second;
+            }
+            widenRange(result.startBlock, result.endBlock, shard.startBlock);
+            widenRange(result.startBlock, result.endBlock, shard.endBlock);
+            widenRange(result.firstLogBlock, result.lastLogBlock, shard.firstLogBlock);
+            widenRange(result.firstLogBlock, result.lastLogBlock, shard.lastLogBlock);
+            result.linesScanned += shard.linesScanned;
+            result.malformedLogs += shard.malformedLogs;
+        }
+    }
+    return result;
+}
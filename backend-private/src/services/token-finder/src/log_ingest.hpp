@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "pool_decoder.hpp"
+
+/**
+ * Everything recovered from a set of log dump files
+ */
+struct IngestResult {
+    std::vector<PoolRecord> pools;
+    std::unordered_map<int64_t, int64_t> blockTimestamps; // block number => unix seconds
+    int64_t startBlock = -1;     // lowest block header
+    int64_t endBlock = -1;       // highest block header
+    int64_t firstLogBlock = -1;  // lowest blockNumber on a log line
+    int64_t lastLogBlock = -1;   // highest blockNumber on a log line
+    size_t linesScanned = 0;
+    size_t malformedLogs = 0; // pool event lines that failed to parse or decode
+};
+
+/**
+ * Memory-map JSONL dumps exported from an archive node and decode factory pool events.
+ *
+ * Each line is either an eth_getLogs result entry ("topics", "data", "blockNumber", "address")
+ * or an eth_getBlockByNumber header ("number", "timestamp"). Each file is split on line
+ * boundaries across `threads` workers; only lines carrying the V2/V3 signatures are JSON-parsed.
+ * Throws std::runtime_error if a file can't be opened or mapped.
+ */
+IngestResult ingestLogDumps(const std::vector<std::string>& paths, unsigned threads);
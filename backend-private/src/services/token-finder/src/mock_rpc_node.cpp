@@ -0,0 +1,366 @@
+// Local mock JSON-RPC node for benchmarking token_finder without a paid endpoint.
+//
+// Serves eth_blockNumber, eth_getLogs, eth_getBlockByNumber and eth_call over HTTP/1.1 from
+// a deterministic synthetic chain, optionally replaying recorded responses first. Latency,
+// jitter and error injection are configurable:
+//
+//   mock_rpc_node [--port 18545] [--start-block 20000000] [--blocks 20000]
+//                 [--block-time-ms 0] [--pools-per-block 0.05] [--latency-ms 0] [--jitter-ms 0]
+//                 [--error-rate 0] [--rpc-error-rate 0] [--seed 1] [--fixtures recorded.jsonl]
+//
+// With --block-time-ms 0 the whole chain is visible at once (backfill). Otherwise one block
+// appears every block-time-ms, starting at a whole second so block timestamps are exact.
+// Fixture lines look like {"method": "...", "params": [...], "response": {...}} and are
+// matched on method and params.
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <strings.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <nlohmann/json.hpp>
+#include "cli_options.hpp"
+#include "pool_decoder.hpp"
+#include "socket_io.hpp"
+
+using json = nlohmann::json;
+
+struct MockConfig {
+    int port = 18545;
+    int64_t startBlock = 20000000;
+    int64_t blocks = 20000;
+    int64_t blockTimeMs = 0;
+    double poolsPerBlock = 0.05;
+    int latencyMs = 0;
+    int jitterMs = 0;
+    double errorRate = 0.0;      // answered with HTTP 503
+    double rpcErrorRate = 0.0;   // answered with a JSON-RPC error
+    unsigned seed = 1;
+    std::string fixturesPath;
+};
+
+static MockConfig config;
+static int64_t genesisMs = 0;  // when startBlock appeared, aligned to a whole second
+static std::unordered_map<std::string, json> fixtures;
+static std::mutex rngMutex;
+static std::mt19937 rng;
+
+static int64_t nowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+static std::string word(uint64_t v) {
+    std::ostringstream ss;
+    ss << std::hex << std::setw(64) << std::setfill('0') << v;
+    return ss.str();
+}
+
+/**
+ * Deterministic 20-byte address; the tag in the top bytes keeps pools and tokens apart
+ */
+static std::string addressFor(uint32_t tag, uint64_t index) {
+    std::ostringstream ss;
+    ss << std::hex << std::setfill('0') << std::setw(8) << tag
+       << std::setw(16) << (index * 0x9E3779B97F4A7C15ULL)
+       << std::setw(16) << index;
+    return ss.str();
+}
+
+static int64_t headBlock() {
+    int64_t last = config.startBlock + config.blocks - 1;
+    if (config.blockTimeMs <= 0) {
+        return last;
+    }
+    int64_t elapsed = std::max<int64_t>(0, nowMs() - genesisMs);
+    return std::min(last, config.startBlock + elapsed / config.blockTimeMs);
+}
+
+static int64_t blockTimestamp(int64_t block) {
+    return (genesisMs + (block - config.startBlock) * config.blockTimeMs) / 1000;
+}
+
+/**
+ * Global index range [first, last) of the pools created in `block`
+ */
+static void poolsInBlock(int64_t block, uint64_t& first, uint64_t& last) {
+    double offset = (double)(block - config.startBlock);
+    first = (uint64_t)std::floor(offset * config.poolsPerBlock);
+    last = (uint64_t)std::floor((offset + 1) * config.poolsPerBlock);
+}
+
+static json makeLog(uint64_t poolIndex, int64_t block) {
+    const DexDefinition& dex = DEXES[poolIndex % DEXES.size()];
+    std::string token0 = addressFor(0x70000000, poolIndex);
+    std::string token1 = addressFor(0x7e000000, poolIndex % 16);
+    std::string pool = addressFor(0x50000000, poolIndex);
+
+    json log = {
+        {"address", dex.factoryAddress},
+        {"blockNumber", decimalToHex(block)},
+        {"logIndex", "0x0"},
+        {"transactionHash", "0x" + word(poolIndex)}
+    };
+    if (dex.isV2Style) {
+        log["topics"] = {V2_SIG, "0x" + std::string(24, '0') + token0,
+                         "0x" + std::string(24, '0') + token1,
+                         "0x" + std::string(24, '0') + pool};
+        log["data"] = "0x" + word(poolIndex + 1);
+    } else {
+        log["topics"] = {V3_SIG, "0x" + std::string(24, '0') + token0,
+                         "0x" + std::string(24, '0') + token1, "0x" + word(3000)};
+        log["data"] = "0x" + word(60) + std::string(24, '0') + pool;
+    }
+    return log;
+}
+
+static json getLogs(const json& filter) {
+    int64_t from = std::stoll(filter.value("fromBlock", "0x0").substr(2), nullptr, 16);
+    int64_t to = std::stoll(filter.value("toBlock", "0x0").substr(2), nullptr, 16);
+    from = std::max(from, config.startBlock);
+    to = std::min(to, headBlock());
+    std::string address = filter.value("address", "");
+
+    json logs = json::array();
+    for (int64_t b = from; b <= to; b++) {
+        uint64_t first, last;
+        poolsInBlock(b, first, last);
+        for (uint64_t i = first; i < last; i++) {
+            if (strcasecmp(DEXES[i % DEXES.size()].factoryAddress.c_str(), address.c_str()) == 0) {
+                logs.push_back(makeLog(i, b));
+            }
+        }
+    }
+    return logs;
+}
+
+static std::string abiString(const std::string& s) {
+    std::ostringstream ss;
+    ss << "0x" << word(32) << word(s.size());
+    std::string data;
+    for (unsigned char c : s) {
+        static const char digits[] = "0123456789abcdef";
+        data.push_back(digits[c >> 4]);
+        data.push_back(digits[c & 0x0f]);
+    }
+    data.resize(((data.size() + 63) / 64) * 64, '0');
+    return ss.str() + data;
+}
+
+static json handleCall(const json& request) {
+    std::string method = request.value("method", "");
+    json params = request.value("params", json::array());
+    json id = request.value("id", json(1));
+
+    auto fixture = fixtures.find(method + params.dump());
+    if (fixture != fixtures.end()) {
+        json resp = fixture->second;
+        resp["id"] = id;
+        return resp;
+    }
+
+    json result;
+    if (method == "eth_blockNumber") {
+        result = decimalToHex(headBlock());
+    } else if (method == "eth_getLogs") {
+        result = getLogs(params.at(0));
+    } else if (method == "eth_getBlockByNumber") {
+        int64_t block = std::stoll(params.at(0).get<std::string>().substr(2), nullptr, 16);
+        if (block > headBlock() || block < config.startBlock) {
+            result = nullptr;
+        } else {
+            result = {{"number", decimalToHex(block)}, {"timestamp", decimalToHex(blockTimestamp(block))}};
+        }
+    } else if (method == "eth_call") {
+        std::string to = params.at(0).value("to", "");
+        std::string selector = params.at(0).value("data", "");
+        std::string suffix = to.size() >= 6 ? to.substr(to.size() - 4) : to;
+        result = abiString(selector == "0x95d89b41" ? "TK" + suffix : "Token " + suffix);
+    } else {
+        return {{"jsonrpc", "2.0"}, {"id", id}, {"error", {{"code", -32601}, {"message", "method not found"}}}};
+    }
+    return {{"jsonrpc", "2.0"}, {"id", id}, {"result", result}};
+}
+
+static void sendResponse(int fd, int status, const std::string& body) {
+    std::ostringstream ss;
+    ss << "HTTP/1.1 " << status << (status == 200 ? " OK" : " Service Unavailable") << "\r\n"
+       << "Content-Type: application/json\r\n"
+       << "Content-Length: " << body.size() << "\r\n"
+       << "Connection: keep-alive\r\n\r\n"
+       << body;
+    std::string response = ss.str();
+    sendAll(fd, response.data(), response.size());
+}
+
+// Longest request body accepted; anything bigger is treated as a malformed request
+static const size_t MAX_BODY_BYTES = 16 << 20;
+
+// Serve keep-alive requests until the peer closes. Throws on a request it can't frame.
+static void serveRequests(int fd) {
+    std::string buf;
+    char chunk[16384];
+    while (true) {
+        // Read one request: headers, then Content-Length bytes of body
+        size_t headerEnd;
+        while ((headerEnd = buf.find("\r\n\r\n")) == std::string::npos) {
+            ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0);
+            if (n <= 0) return;
+            buf.append(chunk, (size_t)n);
+        }
+        size_t contentLength = 0;
+        std::string headers = buf.substr(0, headerEnd);
+        for (auto& c : headers) c = (char)std::tolower((unsigned char)c);
+        size_t cl = headers.find("content-length:");
+        if (cl != std::string::npos) {
+            contentLength = std::stoul(headers.substr(cl + 15));
+            if (contentLength > MAX_BODY_BYTES) {
+                throw std::runtime_error("content-length too large: " + std::to_string(contentLength));
+            }
+        }
+        while (buf.size() < headerEnd + 4 + contentLength) {
+            ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0);
+            if (n <= 0) return;
+            buf.append(chunk, (size_t)n);
+        }
+        std::string body = buf.substr(headerEnd + 4, contentLength);
+        buf.erase(0, headerEnd + 4 + contentLength);
+
+        int delayMs;
+        double roll, rpcRoll;
+        {
+            std::lock_guard<std::mutex> lock(rngMutex);
+            std::uniform_int_distribution<int> jitter(-config.jitterMs, config.jitterMs);
+            std::uniform_real_distribution<double> unit(0.0, 1.0);
+            delayMs = std::max(0, config.latencyMs + jitter(rng));
+            roll = unit(rng);
+            rpcRoll = unit(rng);
+        }
+        if (delayMs > 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(delayMs));
+        }
+
+        if (roll < config.errorRate) {
+            sendResponse(fd, 503, "{\"error\":\"injected\"}");
+            continue;
+        }
+        json response;
+        try {
+            json request = json::parse(body);
+            if (rpcRoll < config.rpcErrorRate) {
+                response = {{"jsonrpc", "2.0"}, {"id", request.value("id", json(1))},
+                            {"error", {{"code", -32000}, {"message", "injected error"}}}};
+            } else {
+                response = handleCall(request);
+            }
+        } catch (const std::exception& e) {
+            response = {{"jsonrpc", "2.0"}, {"id", nullptr},
+                        {"error", {{"code", -32700}, {"message", e.what()}}}};
+        }
+        sendResponse(fd, 200, response.dump());
+    }
+}
+
+// Runs detached, so nothing may escape: a bad request drops its connection, not the node
+static void serveConnection(int fd) {
+    try {
+        serveRequests(fd);
+    } catch (const std::exception& e) {
+        std::cerr << "dropping connection: " << e.what() << std::endl;
+    }
+    ::close(fd);
+}
+
+static void loadFixtures(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        throw std::runtime_error("Cannot open fixtures " + path);
+    }
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty()) continue;
+        json entry = json::parse(line);
+        fixtures[entry.at("method").get<std::string>() + entry.value("params", json::array()).dump()] = entry.at("response");
+    }
+}
+
+int main(int argc, char* argv[]) {
+    const std::string usage = std::string("Usage: ") + argv[0]
+        + " [--port 18545] [--start-block N] [--blocks N] [--block-time-ms N] [--pools-per-block X]"
+          " [--latency-ms N] [--jitter-ms N] [--error-rate X] [--rpc-error-rate X] [--seed N]"
+          " [--fixtures <file.jsonl>]";
+    CliOptions opts;
+    bool ok = opts.parse(argc, argv, {"--port", "--start-block", "--blocks", "--block-time-ms",
+                                      "--pools-per-block", "--latency-ms", "--jitter-ms", "--error-rate",
+                                      "--rpc-error-rate", "--seed", "--fixtures"});
+    if (ok && opts.helpRequested()) {
+        std::cout << usage << std::endl;
+        return 0;
+    }
+    try {
+        config.port          = (int)opts.getInt("--port", config.port);
+        config.startBlock    = opts.getInt("--start-block", config.startBlock);
+        config.blocks        = std::max<int64_t>(1, opts.getInt("--blocks", config.blocks));
+        config.blockTimeMs   = opts.getInt("--block-time-ms", config.blockTimeMs);
+        config.poolsPerBlock = opts.getDouble("--pools-per-block", config.poolsPerBlock);
+        config.latencyMs     = (int)opts.getInt("--latency-ms", config.latencyMs);
+        config.jitterMs      = (int)opts.getInt("--jitter-ms", config.jitterMs);
+        config.errorRate     = opts.getDouble("--error-rate", config.errorRate);
+        config.rpcErrorRate  = opts.getDouble("--rpc-error-rate", config.rpcErrorRate);
+        config.seed          = (unsigned)opts.getInt("--seed", config.seed);
+        config.fixturesPath  = opts.get("--fixtures", config.fixturesPath);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        ok = false;
+    }
+    if (!ok) {
+        std::cerr << usage << std::endl;
+        return 1;
+    }
+    rng.seed(config.seed);
+    if (!config.fixturesPath.empty()) {
+        loadFixtures(config.fixturesPath);
+    }
+
+    int listenFd = ::socket(AF_INET, SOCK_STREAM, 0);
+    int one = 1;
+    ::setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons((uint16_t)config.port);
+    if (::bind(listenFd, (sockaddr*)&addr, sizeof(addr)) != 0 || ::listen(listenFd, 128) != 0) {
+        std::cerr << "bind 127.0.0.1:" << config.port << ": " << std::strerror(errno) << std::endl;
+        return 1;
+    }
+
+    // Start the chain on a whole second so second-resolution block timestamps are exact
+    genesisMs = (nowMs() / 1000 + 1) * 1000;
+    std::this_thread::sleep_for(std::chrono::milliseconds(genesisMs - nowMs()));
+
+    std::cout << "mock_rpc_node listening on 127.0.0.1:" << config.port
+              << " blocks " << config.startBlock << ".." << (config.startBlock + config.blocks - 1)
+              << " fixtures " << fixtures.size() << std::endl;
+
+    while (true) {
+        int fd = ::accept(listenFd, nullptr, nullptr);
+        if (fd < 0) {
+            continue;
+        }
+        std::thread(serveConnection, fd).detach();
+    }
+}
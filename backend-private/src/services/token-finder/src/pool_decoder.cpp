@@ -0,0 +1,185 @@
+#include "pool_decoder.hpp"
+
+#include <sstream>
+#include <stdexcept>
+#include "keccak.hpp" // for keccak256
+
+using json = nlohmann::json;
+
+const std::string V2_SIG = keccak256("PairCreated(address,address,address,uint256)");
+const std::string V3_SIG = keccak256("PoolCreated(address,address,uint24,int24,address)");
+
+// We'll handle UniswapV2, SushiSwap, UniswapV3, PancakeSwap
+const std::vector<DexDefinition> DEXES = {
+    {"UniswapV2",   "0x5C69Bee701EF814A2B6a3EDD4B1652CB9cc5aA6f", true},
+    {"SushiSwap",   "0xC0AEe478e3658e2610c5F7A4A2E1777Ce9e4f2Ac", true},
+    {"UniswapV3",   "0x1F98431c8aD98523631AE4a59f267346ea31F984", false},
+    {"PancakeSwap", "0xca143ce32fe78f1f7019d7d551a6402fc5350c73", true}
+};
+
+uint8_t dexIdFor(const std::string& dexName) {
+    for (size_t i = 0; i < DEXES.size(); i++) {
+        if (DEXES[i].dexName == dexName) {
+            return (uint8_t)i;
+        }
+    }
+    return DEX_ID_UNKNOWN;
+}
+
+/**
+ * decode typical ABI-encoded string
+ */
+std::string decodeStringFromHex(const std::string& hexData) {
+    if (hexData.size() < 2 || hexData.rfind("0x", 0) != 0) {
+        return "";
+    }
+    std::string raw = hexData.substr(2);
+
+    if (raw.size() < 128) {
+        return "";
+    }
+
+    uint64_t length = std::stoull(raw.substr(64, 64), nullptr, 16);
+    if (length > 1000) {
+        return "";
+    }
+
+    size_t dataStart = 128;
+    size_t stringHexLen = length * 2;
+    if (dataStart + stringHexLen > raw.size()) {
+        return "";
+    }
+
+    std::string hexStringBytes = raw.substr(dataStart, stringHexLen);
+    std::string result;
+    result.reserve(length);
+
+    for (size_t i = 0; i < stringHexLen; i += 2) {
+        std::string byteStr = hexStringBytes.substr(i, 2);
+        char c = static_cast<char>(std::stoi(byteStr, nullptr, 16));
+        result.push_back(c);
+    }
+    return result;
+}
+
+/**
+ * Format a block number as a 0x-prefixed hex quantity
+ */
+std::string decimalToHex(int64_t blockNum) {
+    std::ostringstream ss;
+    ss << "0x" << std::hex << blockNum;
+    return ss.str();
+}
+
+/**
+ * Convert last 20 bytes from a zero-padded 32-byte => "0x..."
+ */
+std::string topicToAddress(const std::string& topic) {
+    if (topic.size() < 66) {
+        return "";
+    }
+    return "0x" + topic.substr(topic.size() - 40);
+}
+
+static int hexDigit(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+bool addressFromHex(const std::string& hex, uint8_t out[20]) {
+    if (hex.size() != 42 || hex[0] != '0' || (hex[1] != 'x' && hex[1] != 'X')) {
+        return false;
+    }
+    for (size_t i = 0; i < 20; i++) {
+        int hi = hexDigit(hex[2 + 2 * i]);
+        int lo = hexDigit(hex[3 + 2 * i]);
+        if (hi < 0 || lo < 0) {
+            return false;
+        }
+        out[i] = (uint8_t)((hi << 4) | lo);
+    }
+    return true;
+}
+
+std::string addressToHex(const uint8_t in[20]) {
+    static const char digits[] = "0123456789abcdef";
+    std::string out = "0x";
+    out.reserve(42);
+    for (size_t i = 0; i < 20; i++) {
+        out.push_back(digits[in[i] >> 4]);
+        out.push_back(digits[in[i] & 0x0f]);
+    }
+    return out;
+}
+
+/**
+ * Decode a factory log into a PoolRecord. Returns false for logs that don't carry a pool.
+ */
+bool decodePoolLog(const DexDefinition& dex, const json& logEntry, PoolRecord& out, std::string* error) {
+    try {
+        // at() throws on missing keys; const operator[] would be undefined behaviour
+        const json& topicsArr = logEntry.at("topics");
+        if (!topicsArr.is_array() || topicsArr.size() < 3) {
+            return false;
+        }
+
+        out = PoolRecord();
+        out.dexName = dex.dexName;
+        out.blockHex = logEntry.at("blockNumber").get<std::string>();
+
+        if (dex.isV2Style) {
+            // PairCreated => might be 4 topics or 3
+            if (topicsArr.size() == 4) {
+                // official => pair in topics[3]
+                out.token0 = topicToAddress(topicsArr.at(1).get<std::string>());
+                out.token1 = topicToAddress(topicsArr.at(2).get<std::string>());
+                out.poolAddress = topicToAddress(topicsArr.at(3).get<std::string>());
+            }
+            else if (topicsArr.size() == 3) {
+                // older fork => pair in data
+                out.token0 = topicToAddress(topicsArr.at(1).get<std::string>());
+                out.token1 = topicToAddress(topicsArr.at(2).get<std::string>());
+                std::string dataStr = logEntry.at("data").get<std::string>();
+                if (dataStr.size() >= 66) {
+                    out.poolAddress = "0x" + dataStr.substr(2, 40);
+                }
+            }
+            else {
+                return false;
+            }
+        }
+        else {
+            // V3 => topics[3] => fee, data => pool
+            if (topicsArr.size() < 4) {
+                return false;
+            }
+            out.token0 = topicToAddress(topicsArr.at(1).get<std::string>());
+            out.token1 = topicToAddress(topicsArr.at(2).get<std::string>());
+
+            std::string feeTopic = topicsArr.at(3).get<std::string>();
+            if (feeTopic.size() >= 66) {
+                uint64_t feeRaw = std::stoull(feeTopic.substr(2), nullptr, 16);
+                out.fee = (int)(feeRaw & 0xFFFFFF);
+            }
+
+            std::string dataStr = logEntry.at("data").get<std::string>();
+            if (dataStr.size() >= 130) {
+                std::string w1 = dataStr.substr(2, 64);
+                std::string w2 = dataStr.substr(66, 64);
+
+                uint64_t val1 = std::stoull(w1, nullptr, 16);
+                out.tickSpacing = (int)(val1 & 0xFFFFFF);
+
+                out.poolAddress = "0x" + w2.substr(w2.size() - 40);
+            }
+        }
+    } catch (const std::exception& e) {
+        if (error) {
+            *error = e.what();
+        }
+        return false;
+    }
+    return !out.poolAddress.empty();
+}
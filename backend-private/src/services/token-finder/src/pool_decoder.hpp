@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+// Uniswap V2 => PairCreated => "0x0d3648bd..."
+// Uniswap V3 => PoolCreated => "0x783cca1c..."
+extern const std::string V2_SIG;
+extern const std::string V3_SIG;
+
+struct DexDefinition {
+    std::string dexName;
+    std::string factoryAddress;
+    bool isV2Style;
+};
+
+// We'll handle UniswapV2, SushiSwap, UniswapV3, PancakeSwap
+extern const std::vector<DexDefinition> DEXES;
+
+// dexId for a pool whose dexName isn't in DEXES
+static const uint8_t DEX_ID_UNKNOWN = 0xff;
+
+/**
+ * Index of dexName in DEXES, or DEX_ID_UNKNOWN
+ */
+uint8_t dexIdFor(const std::string& dexName);
+
+/**
+ * A pool decoded from a PairCreated / PoolCreated log, before token metadata is fetched
+ */
+struct PoolRecord {
+    std::string dexName;
+    std::string poolAddress;
+    std::string token0;
+    std::string token1;
+    int fee = 0;
+    int tickSpacing = 0;
+    std::string blockHex;
+};
+
+/**
+ * decode typical ABI-encoded string
+ */
+std::string decodeStringFromHex(const std::string& hexData);
+
+/**
+ * Format a block number as a 0x-prefixed hex quantity
+ */
+std::string decimalToHex(int64_t blockNum);
+
+/**
+ * Convert last 20 bytes from a zero-padded 32-byte => "0x..."
+ */
+std::string topicToAddress(const std::string& topic);
+
+/**
+ * Parse a "0x"-prefixed 40-hex-digit address into 20 bytes. Returns false if malformed.
+ */
+bool addressFromHex(const std::string& hex, uint8_t out[20]);
+
+/**
+ * Format 20 address bytes as lowercase "0x..."
+ */
+std::string addressToHex(const uint8_t in[20]);
+
+/**
+ * Decode a factory log into a PoolRecord. Returns false for logs that don't carry a pool,
+ * including malformed ones; for those, `error` (if given) receives the reason.
+ */
+bool decodePoolLog(const DexDefinition& dex, const nlohmann::json& logEntry, PoolRecord& out,
+                   std::string* error = nullptr);
@@ -0,0 +1,149 @@
+#include "pool_feed.hpp"
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+uint64_t feedClockNs() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+bool readShmRecord(const PoolFeedShmHeader* header, uint64_t sequence, PoolFeedRecord& out) {
+    if (sequence == 0 || sequence > header->lastSequence.load(std::memory_order_acquire)) {
+        return false;
+    }
+    auto* slots = reinterpret_cast<const PoolFeedShmSlot*>(header + 1);
+    const PoolFeedShmSlot& slot = slots[sequence % header->capacity];
+
+    if (slot.sequence.load(std::memory_order_acquire) != sequence) {
+        return false;
+    }
+    std::memcpy(&out, &slot.record, sizeof(out));
+    std::atomic_thread_fence(std::memory_order_acquire);
+    // Producer may have lapped us while we copied
+    return slot.sequence.load(std::memory_order_relaxed) == sequence;
+}
+
+PoolFeed::PoolFeed(const std::string& socketPath, const std::string& shmName, size_t capacity)
+    : socketPath_(socketPath), shmName_(shmName), capacity_(std::max<size_t>(1, capacity)), streamId_(feedClockNs())
+{
+    if (!shmName_.empty()) {
+        // Replace any ring left by a previous run instead of rewriting it under readers that
+        // still have it mapped; they notice the new object and remap (see feed_client)
+        ::shm_unlink(shmName_.c_str());
+        int fd = ::shm_open(shmName_.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+        if (fd < 0) {
+            throw std::runtime_error("shm_open " + shmName_ + ": " + std::strerror(errno));
+        }
+        shmSize_ = sizeof(PoolFeedShmHeader) + capacity_ * sizeof(PoolFeedShmSlot);
+        if (::ftruncate(fd, (off_t)shmSize_) != 0) {
+            int err = errno;
+            ::close(fd);
+            throw std::runtime_error("ftruncate " + shmName_ + ": " + std::strerror(err));
+        }
+        void* p = ::mmap(nullptr, shmSize_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) {
+            throw std::runtime_error("mmap " + shmName_ + ": " + std::strerror(errno));
+        }
+        shmHeader_ = static_cast<PoolFeedShmHeader*>(p);
+        shmHeader_->recordSize = sizeof(PoolFeedRecord);
+        shmHeader_->capacity = capacity_;
+        shmHeader_->streamId = streamId_;
+        shmHeader_->lastSequence.store(0, std::memory_order_relaxed);
+        // A fresh object is zero-filled; readers check the magic last, so it only appears
+        // once the header is complete
+        std::atomic_thread_fence(std::memory_order_release);
+        shmHeader_->magic = POOL_FEED_SHM_MAGIC;
+    }
+
+    if (!socketPath_.empty()) {
+        try {
+            server_.reset(new UnixSocketServer(socketPath_, 16, [this](int fd) { serveSubscriber(fd); }));
+        } catch (...) {
+            if (shmHeader_) {
+                ::munmap(shmHeader_, shmSize_);
+            }
+            throw;
+        }
+    }
+}
+
+PoolFeed::~PoolFeed() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    // Subscribers waiting for records wake up and return before the server joins them
+    changed_.notify_all();
+    server_.reset();
+
+    if (shmHeader_) {
+        ::munmap(shmHeader_, shmSize_);
+    }
+}
+
+void PoolFeed::publish(PoolFeedRecord rec) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        rec.sequence = nextSequence_++;
+        rec.publishedNs = feedClockNs();
+
+        if (shmHeader_) {
+            auto* slots = reinterpret_cast<PoolFeedShmSlot*>(shmHeader_ + 1);
+            PoolFeedShmSlot& slot = slots[rec.sequence % capacity_];
+            slot.sequence.store(0, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            std::memcpy(&slot.record, &rec, sizeof(rec));
+            slot.sequence.store(rec.sequence, std::memory_order_release);
+            shmHeader_->lastSequence.store(rec.sequence, std::memory_order_release);
+        }
+
+        if (server_) {
+            backlog_.push_back(rec);
+            if (backlog_.size() > capacity_) {
+                backlog_.pop_front();
+            }
+        }
+    }
+    changed_.notify_all();
+}
+
+void PoolFeed::serveSubscriber(int fd) {
+    uint64_t cursor = 0;
+    if (recvAll(fd, &cursor, sizeof(cursor))) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        PoolFeedHello hello{streamId_, backlog_.empty() ? 0 : backlog_.front().sequence};
+        if (cursor == 0 || cursor > nextSequence_) {
+            cursor = nextSequence_;
+        }
+
+        std::vector<PoolFeedRecord> batch;
+        lock.unlock();
+        bool ok = sendAll(fd, &hello, sizeof(hello));
+        lock.lock();
+
+        while (ok && !stopping_) {
+            changed_.wait(lock, [&] { return stopping_ || cursor < nextSequence_; });
+            if (stopping_) {
+                break;
+            }
+            uint64_t oldest = backlog_.front().sequence;
+            if (cursor < oldest) {
+                // Fell out of the backlog; reconnecting shows the gap via oldestSequence
+                break;
+            }
+            batch.assign(backlog_.begin() + (cursor - oldest), backlog_.end());
+            cursor = nextSequence_;
+
+            lock.unlock();
+            ok = sendAll(fd, batch.data(), batch.size() * sizeof(PoolFeedRecord));
+            lock.lock();
+        }
+    }
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include "socket_io.hpp"
+
+/**
+ * One newly inserted pool as pushed to subscribers. Fixed 112-byte layout in host byte
+ * order, shared by the socket stream and the shared-memory ring.
+ */
+struct PoolFeedRecord {
+    uint64_t sequence;        // 1, 2, 3, ... within one stream
+    uint64_t publishedNs;     // CLOCK_REALTIME at publish, for latency measurement
+    int64_t  blockNumber;
+    int64_t  blockTimestamp;  // unix seconds
+    uint32_t fee;
+    int32_t  tickSpacing;
+    uint8_t  dexId;           // index into DEXES, DEX_ID_UNKNOWN if not listed
+    uint8_t  reserved[7];
+    uint8_t  pool[20];
+    uint8_t  token0[20];
+    uint8_t  token1[20];
+    uint8_t  padding[4];
+};
+static_assert(sizeof(PoolFeedRecord) == 112, "PoolFeedRecord layout is part of the wire format");
+
+/**
+ * Sent by the server right after a subscriber's 8-byte "from sequence" request.
+ * streamId changes on every restart; sequences from a different stream are meaningless.
+ */
+struct PoolFeedHello {
+    uint64_t streamId;
+    uint64_t oldestSequence;  // oldest record still replayable, 0 if none yet
+};
+static_assert(sizeof(PoolFeedHello) == 16, "PoolFeedHello layout is part of the wire format");
+
+/**
+ * CLOCK_REALTIME in nanoseconds, the clock of PoolFeedRecord::publishedNs
+ */
+uint64_t feedClockNs();
+
+static const uint64_t POOL_FEED_SHM_MAGIC = 0x31444545464c4f50ULL; // "POLFEED1" little-endian
+
+/**
+ * Shared-memory ring header, followed by `capacity` PoolFeedShmSlot entries.
+ * Single producer; readers never write.
+ */
+struct PoolFeedShmHeader {
+    uint64_t magic;
+    uint32_t recordSize;
+    uint32_t reserved;
+    uint64_t capacity;
+    uint64_t streamId;
+    std::atomic<uint64_t> lastSequence;  // highest fully written sequence
+};
+
+/**
+ * Ring slot guarded like a seqlock: `sequence` is 0 while the producer rewrites the record.
+ */
+struct PoolFeedShmSlot {
+    std::atomic<uint64_t> sequence;
+    PoolFeedRecord record;
+};
+
+/**
+ * Copy the record for `sequence` out of a mapped ring. Returns false if that sequence was
+ * not written yet or has already been overwritten.
+ */
+bool readShmRecord(const PoolFeedShmHeader* header, uint64_t sequence, PoolFeedRecord& out);
+
+/**
+ * Publishes pools to local subscribers over a Unix domain socket and/or a shared-memory ring.
+ *
+ * Socket subscribers connect, send the next sequence they want (0 = only new records) and
+ * get a PoolFeedHello followed by a stream of PoolFeedRecords, replayed from the in-memory
+ * backlog of the last `capacity` records. A subscriber that falls further behind than that
+ * is disconnected and can reconnect from its last sequence.
+ */
+class PoolFeed {
+public:
+    /**
+     * An empty socketPath or shmName disables that transport. Throws std::runtime_error
+     * if an enabled transport can't be set up.
+     */
+    PoolFeed(const std::string& socketPath, const std::string& shmName, size_t capacity);
+    ~PoolFeed();
+
+    PoolFeed(const PoolFeed&) = delete;
+    PoolFeed& operator=(const PoolFeed&) = delete;
+
+    /**
+     * Assign the next sequence and publish time to `rec` and push it to every transport
+     */
+    void publish(PoolFeedRecord rec);
+
+private:
+    void serveSubscriber(int fd);
+
+    std::string socketPath_;
+    std::string shmName_;
+    size_t capacity_;
+    uint64_t streamId_;
+
+    // Socket backlog and subscribers
+    std::mutex mutex_;
+    std::condition_variable changed_;
+    std::deque<PoolFeedRecord> backlog_;
+    uint64_t nextSequence_ = 1;
+    bool stopping_ = false;
+    std::unique_ptr<UnixSocketServer> server_;
+
+    // Shared-memory ring
+    PoolFeedShmHeader* shmHeader_ = nullptr;
+    size_t shmSize_ = 0;
+};
@@ -0,0 +1,226 @@
+#include "pool_index.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <sys/socket.h>
+
+// Callers index with the high bits, which the multiply mixes best
+static uint64_t addressHash(const uint8_t addr[20]) {
+    uint64_t a, b;
+    uint32_t c;
+    std::memcpy(&a, addr, sizeof(a));
+    std::memcpy(&b, addr + 8, sizeof(b));
+    std::memcpy(&c, addr + 16, sizeof(c));
+    return (a ^ b ^ c) * 0x9E3779B97F4A7C15ULL;
+}
+
+static unsigned log2Of(size_t capacity) {
+    unsigned bits = 0;
+    while (((size_t)1 << bits) < capacity) {
+        bits++;
+    }
+    return bits;
+}
+
+AddressTable::AddressTable(size_t expected) {
+    size_t capacity = 16;
+    while (capacity < expected * 2) {
+        capacity <<= 1;
+    }
+    slots_.assign(capacity, Slot{{}, NOT_FOUND});
+    mask_ = capacity - 1;
+    shift_ = 64 - log2Of(capacity);
+}
+
+uint32_t AddressTable::find(const uint8_t addr[20]) const {
+    for (size_t i = addressHash(addr) >> shift_; ; i = (i + 1) & mask_) {
+        const Slot& slot = slots_[i];
+        if (slot.id == NOT_FOUND) {
+            return NOT_FOUND;
+        }
+        if (std::memcmp(slot.addr, addr, 20) == 0) {
+            return slot.id;
+        }
+    }
+}
+
+uint32_t AddressTable::findOrInsert(const uint8_t addr[20], uint32_t newId) {
+    if ((size_ + 1) * 2 > slots_.size()) {
+        grow();
+    }
+    for (size_t i = addressHash(addr) >> shift_; ; i = (i + 1) & mask_) {
+        Slot& slot = slots_[i];
+        if (slot.id == NOT_FOUND) {
+            std::memcpy(slot.addr, addr, 20);
+            slot.id = newId;
+            size_++;
+            return newId;
+        }
+        if (std::memcmp(slot.addr, addr, 20) == 0) {
+            return slot.id;
+        }
+    }
+}
+
+void AddressTable::grow() {
+    std::vector<Slot> old;
+    old.swap(slots_);
+    slots_.assign(old.size() * 2, Slot{{}, NOT_FOUND});
+    mask_ = slots_.size() - 1;
+    shift_ = 64 - log2Of(slots_.size());
+    for (const Slot& slot : old) {
+        if (slot.id == NOT_FOUND) {
+            continue;
+        }
+        size_t i = addressHash(slot.addr) >> shift_;
+        while (slots_[i].id != NOT_FOUND) {
+            i = (i + 1) & mask_;
+        }
+        slots_[i] = slot;
+    }
+}
+
+uint32_t PoolIndex::tokenId(const uint8_t addr[20]) {
+    uint32_t id = tokenTable_.findOrInsert(addr, (uint32_t)tokens_.size());
+    if (id == tokens_.size()) {
+        tokens_.emplace_back();
+    }
+    return id;
+}
+
+void PoolIndex::linkPool(uint32_t tokenId, uint32_t poolId) {
+    auto& ids = tokens_[tokenId].poolIds;
+    if (std::find(ids.begin(), ids.end(), poolId) == ids.end()) {
+        ids.push_back(poolId);
+    }
+}
+
+void PoolIndex::upsertPool(const IndexedPool& pool,
+                           const std::string& token0Symbol, const std::string& token0Name,
+                           const std::string& token1Symbol, const std::string& token1Name)
+{
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+
+    uint32_t poolId = poolTable_.findOrInsert(pool.pool, (uint32_t)pools_.size());
+    if (poolId == pools_.size()) {
+        pools_.push_back(pool);
+    } else {
+        pools_[poolId] = pool;
+    }
+
+    uint32_t t0 = tokenId(pool.token0);
+    uint32_t t1 = tokenId(pool.token1);
+    linkPool(t0, poolId);
+    linkPool(t1, poolId);
+
+    auto setIfKnown = [](std::string& field, const std::string& value) {
+        if (!value.empty()) {
+            field = value;
+        }
+    };
+    setIfKnown(tokens_[t0].symbol, token0Symbol);
+    setIfKnown(tokens_[t0].name, token0Name);
+    setIfKnown(tokens_[t1].symbol, token1Symbol);
+    setIfKnown(tokens_[t1].name, token1Name);
+}
+
+bool PoolIndex::poolsForToken(const uint8_t token[20], std::vector<IndexedPool>& out) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    uint32_t id = tokenTable_.find(token);
+    if (id == AddressTable::NOT_FOUND) {
+        return false;
+    }
+    for (uint32_t poolId : tokens_[id].poolIds) {
+        out.push_back(pools_[poolId]);
+    }
+    return true;
+}
+
+bool PoolIndex::tokenInfo(const uint8_t token[20], std::string& symbol, std::string& name) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    uint32_t id = tokenTable_.find(token);
+    if (id == AddressTable::NOT_FOUND) {
+        return false;
+    }
+    symbol = tokens_[id].symbol;
+    name = tokens_[id].name;
+    return true;
+}
+
+size_t PoolIndex::poolCount() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return pools_.size();
+}
+
+size_t PoolIndex::tokenCount() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return tokens_.size();
+}
+
+PoolIndexServer::PoolIndexServer(const PoolIndex& index, const std::string& socketPath)
+    : index_(index), server_(socketPath, 64, [this](int fd) { serveClient(fd); })
+{
+}
+
+static void appendBytes(std::vector<char>& buf, const void* data, size_t len) {
+    const char* p = static_cast<const char*>(data);
+    buf.insert(buf.end(), p, p + len);
+}
+
+void PoolIndexServer::serveClient(int fd) {
+    const size_t requestSize = 21;
+    std::vector<char> in(64 * 1024);
+    size_t have = 0;
+    std::vector<char> out;
+    std::vector<IndexedPool> pools;
+    std::string symbol, name;
+
+    while (true) {
+        ssize_t n = ::recv(fd, in.data() + have, in.size() - have, 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        have += (size_t)n;
+
+        // Answer every complete request in the buffer with one send, so pipelined clients batch
+        size_t pos = 0;
+        out.clear();
+        for (; pos + requestSize <= have; pos += requestSize) {
+            uint8_t op = (uint8_t)in[pos];
+            const uint8_t* token = reinterpret_cast<const uint8_t*>(in.data() + pos + 1);
+            IndexResponseHeader header{INDEX_STATUS_OK, {0, 0, 0}, 0};
+
+            if (op == INDEX_OP_POOLS_FOR_TOKEN) {
+                pools.clear();
+                if (!index_.poolsForToken(token, pools)) {
+                    header.status = INDEX_STATUS_NOT_FOUND;
+                }
+                header.length = (uint32_t)(pools.size() * sizeof(IndexedPool));
+                appendBytes(out, &header, sizeof(header));
+                appendBytes(out, pools.data(), header.length);
+            } else if (op == INDEX_OP_TOKEN_INFO) {
+                if (!index_.tokenInfo(token, symbol, name)) {
+                    header.status = INDEX_STATUS_NOT_FOUND;
+                    appendBytes(out, &header, sizeof(header));
+                    continue;
+                }
+                uint16_t lens[2] = {(uint16_t)std::min<size_t>(symbol.size(), UINT16_MAX),
+                                    (uint16_t)std::min<size_t>(name.size(), UINT16_MAX)};
+                header.length = (uint32_t)(sizeof(lens) + lens[0] + lens[1]);
+                appendBytes(out, &header, sizeof(header));
+                appendBytes(out, lens, sizeof(lens));
+                appendBytes(out, symbol.data(), lens[0]);
+                appendBytes(out, name.data(), lens[1]);
+            } else {
+                header.status = INDEX_STATUS_BAD_REQUEST;
+                appendBytes(out, &header, sizeof(header));
+            }
+        }
+        std::memmove(in.data(), in.data() + pos, have - pos);
+        have -= pos;
+
+        if (!out.empty() && !sendAll(fd, out.data(), out.size())) {
+            break;
+        }
+    }
+}
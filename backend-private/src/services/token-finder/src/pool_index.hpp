@@ -0,0 +1,135 @@
+#pragma once
+
+#include <cstdint>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+#include "socket_io.hpp"
+
+/**
+ * One pool as stored in the index and returned on the wire. Fixed 80-byte layout in host
+ * byte order.
+ */
+struct IndexedPool {
+    int64_t  blockNumber;
+    uint32_t fee;
+    int32_t  tickSpacing;
+    uint8_t  dexId;           // index into DEXES, DEX_ID_UNKNOWN if not listed
+    uint8_t  reserved[3];
+    uint8_t  pool[20];
+    uint8_t  token0[20];
+    uint8_t  token1[20];
+};
+static_assert(sizeof(IndexedPool) == 80, "IndexedPool layout is part of the wire format");
+
+/**
+ * Open-addressing hash from a 20-byte address to a dense id. All 20 bytes are folded and
+ * multiplied (Fibonacci hashing) and the high bits pick the slot, so vanity or leading-zero
+ * prefixes don't cluster. Linear probing, kept at most half full.
+ */
+class AddressTable {
+public:
+    static const uint32_t NOT_FOUND = UINT32_MAX;
+
+    explicit AddressTable(size_t expected = 1024);
+
+    uint32_t find(const uint8_t addr[20]) const;
+
+    /**
+     * Return the id for addr, inserting `newId` if it isn't present yet
+     */
+    uint32_t findOrInsert(const uint8_t addr[20], uint32_t newId);
+
+    size_t size() const { return size_; }
+
+private:
+    struct Slot {
+        uint8_t addr[20];
+        uint32_t id;          // NOT_FOUND marks an empty slot
+    };
+
+    void grow();
+
+    std::vector<Slot> slots_;
+    size_t mask_ = 0;
+    unsigned shift_ = 64;
+    size_t size_ = 0;
+};
+
+/**
+ * In-memory token => pools index mirroring liquidity_pools. Pools live in one flat array,
+ * each token keeps the ids of its pools. Safe for concurrent readers with one writer.
+ */
+class PoolIndex {
+public:
+    /**
+     * Insert or update a pool and refresh both tokens' symbol/name. Empty metadata never
+     * overwrites a known value.
+     */
+    void upsertPool(const IndexedPool& pool,
+                    const std::string& token0Symbol, const std::string& token0Name,
+                    const std::string& token1Symbol, const std::string& token1Name);
+
+    /**
+     * Append every pool containing `token` to out. Returns false if the token is unknown.
+     */
+    bool poolsForToken(const uint8_t token[20], std::vector<IndexedPool>& out) const;
+
+    /**
+     * Returns false if the token is unknown
+     */
+    bool tokenInfo(const uint8_t token[20], std::string& symbol, std::string& name) const;
+
+    size_t poolCount() const;
+    size_t tokenCount() const;
+
+private:
+    struct TokenEntry {
+        std::string symbol;
+        std::string name;
+        std::vector<uint32_t> poolIds;
+    };
+
+    uint32_t tokenId(const uint8_t addr[20]);
+    void linkPool(uint32_t tokenId, uint32_t poolId);
+
+    mutable std::shared_mutex mutex_;
+    AddressTable poolTable_;
+    AddressTable tokenTable_;
+    std::vector<IndexedPool> pools_;
+    std::vector<TokenEntry> tokens_;
+};
+
+// Index socket protocol: each request is a 1-byte op followed by a 20-byte token address,
+// answered in order with an IndexResponseHeader and `length` payload bytes.
+static const uint8_t INDEX_OP_POOLS_FOR_TOKEN = 1;  // payload: IndexedPool[]
+static const uint8_t INDEX_OP_TOKEN_INFO      = 2;  // payload: u16 symbolLen, u16 nameLen, symbol, name
+
+static const uint8_t INDEX_STATUS_OK          = 0;
+static const uint8_t INDEX_STATUS_NOT_FOUND   = 1;
+static const uint8_t INDEX_STATUS_BAD_REQUEST = 2;
+
+struct IndexResponseHeader {
+    uint8_t  status;
+    uint8_t  reserved[3];
+    uint32_t length;
+};
+static_assert(sizeof(IndexResponseHeader) == 8, "IndexResponseHeader layout is part of the wire format");
+
+/**
+ * Serves a PoolIndex on a Unix domain socket, one thread per client connection.
+ * Throws std::runtime_error if the socket can't be bound.
+ */
+class PoolIndexServer {
+public:
+    PoolIndexServer(const PoolIndex& index, const std::string& socketPath);
+
+    PoolIndexServer(const PoolIndexServer&) = delete;
+    PoolIndexServer& operator=(const PoolIndexServer&) = delete;
+
+private:
+    void serveClient(int fd);
+
+    const PoolIndex& index_;
+    UnixSocketServer server_;  // last, so its handler threads stop before anything else goes
+};
@@ -0,0 +1,155 @@
+#include "socket_io.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+bool sendAll(int fd, const void* buf, size_t len) {
+    const char* p = static_cast<const char*>(buf);
+    while (len > 0) {
+        ssize_t n = ::send(fd, p, len, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        p += n;
+        len -= (size_t)n;
+    }
+    return true;
+}
+
+bool recvAll(int fd, void* buf, size_t len) {
+    char* p = static_cast<char*>(buf);
+    while (len > 0) {
+        ssize_t n = ::recv(fd, p, len, 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        p += n;
+        len -= (size_t)n;
+    }
+    return true;
+}
+
+static bool unixAddress(const std::string& path, sockaddr_un& addr) {
+    addr = sockaddr_un{};
+    addr.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(addr.sun_path)) {
+        return false;
+    }
+    std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+    return true;
+}
+
+int connectUnixSocket(const std::string& path) {
+    sockaddr_un addr;
+    if (!unixAddress(path, addr)) {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+    int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    if (::connect(fd, (sockaddr*)&addr, sizeof(addr)) != 0) {
+        int err = errno;
+        ::close(fd);
+        errno = err;
+        return -1;
+    }
+    return fd;
+}
+
+UnixSocketServer::UnixSocketServer(const std::string& socketPath, int backlog, Handler handler)
+    : socketPath_(socketPath), handler_(std::move(handler))
+{
+    sockaddr_un addr;
+    if (!unixAddress(socketPath_, addr)) {
+        throw std::runtime_error("Socket path too long: " + socketPath_);
+    }
+
+    listenFd_ = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listenFd_ < 0) {
+        throw std::runtime_error(std::string("socket: ") + std::strerror(errno));
+    }
+    ::unlink(socketPath_.c_str());
+    if (::bind(listenFd_, (sockaddr*)&addr, sizeof(addr)) != 0 || ::listen(listenFd_, backlog) != 0) {
+        int err = errno;
+        ::close(listenFd_);
+        throw std::runtime_error("bind/listen " + socketPath_ + ": " + std::strerror(err));
+    }
+    if (::pipe(wakePipe_) != 0) {
+        int err = errno;
+        ::close(listenFd_);
+        ::unlink(socketPath_.c_str());
+        throw std::runtime_error(std::string("pipe: ") + std::strerror(err));
+    }
+    acceptor_ = std::thread(&UnixSocketServer::acceptLoop, this);
+}
+
+UnixSocketServer::~UnixSocketServer() {
+    ssize_t ignored = ::write(wakePipe_[1], "x", 1);
+    (void)ignored;
+    acceptor_.join();
+    reapConnections(true);
+
+    ::close(listenFd_);
+    ::unlink(socketPath_.c_str());
+    ::close(wakePipe_[0]);
+    ::close(wakePipe_[1]);
+}
+
+void UnixSocketServer::acceptLoop() {
+    while (true) {
+        pollfd fds[2] = {{listenFd_, POLLIN, 0}, {wakePipe_[0], POLLIN, 0}};
+        if (::poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) continue;
+            return;
+        }
+        if (fds[1].revents) {
+            return;
+        }
+        if (!(fds[0].revents & POLLIN)) {
+            continue;
+        }
+        int fd = ::accept4(listenFd_, nullptr, nullptr, SOCK_CLOEXEC);
+        if (fd < 0) {
+            continue;
+        }
+
+        reapConnections(false);
+        auto finished = std::make_shared<std::atomic<bool>>(false);
+        std::lock_guard<std::mutex> lock(connectionsMutex_);
+        connections_.push_back({fd, finished, std::thread([this, fd, finished]() {
+            handler_(fd);
+            ::shutdown(fd, SHUT_RDWR);
+            finished->store(true);
+        })});
+    }
+}
+
+void UnixSocketServer::reapConnections(bool all) {
+    std::vector<Connection> done;
+    {
+        std::lock_guard<std::mutex> lock(connectionsMutex_);
+        for (auto it = connections_.begin(); it != connections_.end(); ) {
+            if (all || it->finished->load()) {
+                if (all) {
+                    // Unblock a handler waiting in recv() or send()
+                    ::shutdown(it->fd, SHUT_RDWR);
+                }
+                done.push_back(std::move(*it));
+                it = connections_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+    for (auto& conn : done) {
+        conn.thread.join();
+        ::close(conn.fd);
+    }
+}
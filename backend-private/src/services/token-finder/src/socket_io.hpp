@@ -0,0 +1,66 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Write all of buf, or return false if the peer went away
+ */
+bool sendAll(int fd, const void* buf, size_t len);
+
+/**
+ * Read exactly len bytes, or return false on EOF or error
+ */
+bool recvAll(int fd, void* buf, size_t len);
+
+/**
+ * Connect to a Unix domain stream socket. Returns -1 with errno set on failure.
+ */
+int connectUnixSocket(const std::string& path);
+
+/**
+ * Unix domain stream socket server that runs `handler(fd)` on its own thread for each
+ * connection. When the handler returns, the connection is shut down; it is closed and its
+ * thread joined on the next accept or on destruction.
+ *
+ * Destruction stops accepting and shuts down every open connection, which unblocks handlers
+ * waiting in recv()/send(). A handler waiting on anything else must be woken by its owner
+ * before the server is destroyed.
+ */
+class UnixSocketServer {
+public:
+    using Handler = std::function<void(int fd)>;
+
+    /**
+     * Throws std::runtime_error if the socket can't be bound
+     */
+    UnixSocketServer(const std::string& socketPath, int backlog, Handler handler);
+    ~UnixSocketServer();
+
+    UnixSocketServer(const UnixSocketServer&) = delete;
+    UnixSocketServer& operator=(const UnixSocketServer&) = delete;
+
+private:
+    struct Connection {
+        int fd;
+        std::shared_ptr<std::atomic<bool>> finished;
+        std::thread thread;
+    };
+
+    void acceptLoop();
+    void reapConnections(bool all);
+
+    std::string socketPath_;
+    Handler handler_;
+    int listenFd_ = -1;
+    int wakePipe_[2] = {-1, -1};
+    std::thread acceptor_;
+    std::mutex connectionsMutex_;
+    std::vector<Connection> connections_;
+};
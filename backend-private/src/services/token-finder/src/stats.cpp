@@ -0,0 +1,11 @@
+#include "stats.hpp"
+
+#include <algorithm>
+
+double percentileOfSorted(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    size_t idx = std::min(sorted.size() - 1, (size_t)(p * (double)(sorted.size() - 1) + 0.5));
+    return sorted[idx];
+}
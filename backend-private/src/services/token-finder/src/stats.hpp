@@ -0,0 +1,8 @@
+#pragma once
+
+#include <vector>
+
+/**
+ * Nearest-rank percentile (p in [0, 1]) of already sorted values, 0 if there are none
+ */
+double percentileOfSorted(const std::vector<double>& sorted, double p);
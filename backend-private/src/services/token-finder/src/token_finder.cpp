@@ -1,6 +1,8 @@
 #include <iostream>
 #include <string>
 #include <cstdlib>      // getenv
+#include <cstdint>
+#include <cstring>
 #include <stdexcept>
 #include <algorithm>
 #include <sstream>
@@ -8,10 +10,21 @@
 #include <ctime>
 #include <chrono>
 #include <thread>       // for sleep_for
+#include <random>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <map>
+#include <fstream>
+#include <unistd.h>     // gethostname, getpid
 #include <pqxx/pqxx>
 #include <curl/curl.h>
 #include <nlohmann/json.hpp>
-#include "keccak.hpp" // for keccak256
+#include "pool_decoder.hpp"
+#include "log_ingest.hpp"
+#include "pool_feed.hpp"
+#include "pool_index.hpp"
+#include "stats.hpp"
 
 using json = nlohmann::json;
 
@@ -37,6 +50,94 @@ static std::string getEnvOrDefault(const char* varName, const char* defaultVal)
     return (val ? std::string(val) : std::string(defaultVal));
 }
 
+/**
+ * Return integer environment variable or default. A value that isn't an integer in
+ * [minVal, maxVal] is fatal: the error names the variable and the process exits with status 1.
+ */
+static int64_t getEnvIntOrDefault(const char* varName, int64_t defaultVal,
+                                  int64_t minVal = INT64_MIN, int64_t maxVal = INT64_MAX)
+{
+    const char* val = std::getenv(varName);
+    if (!val) {
+        return defaultVal;
+    }
+    try {
+        size_t used = 0;
+        int64_t parsed = std::stoll(val, &used);
+        if (used == std::strlen(val) && parsed >= minVal && parsed <= maxVal) {
+            return parsed;
+        }
+    } catch (const std::exception&) {
+        // reported below
+    }
+    std::cerr << getTimestamp() << "[ERROR] " << varName << " must be an integer";
+    if (minVal != INT64_MIN || maxVal != INT64_MAX) {
+        std::cerr << " between " << minVal << " and " << maxVal;
+    }
+    std::cerr << ", got '" << val << "'" << std::endl;
+    std::exit(1);
+}
+
+/**
+ * Thrown when an RPC request never produced a usable JSON-RPC reply (cURL failure,
+ * non-2xx HTTP status, unparseable body). Distinguishes flaky transport from
+ * JSON-RPC errors such as a reverted eth_call.
+ */
+struct RpcTransportError : public std::runtime_error {
+    using std::runtime_error::runtime_error;
+};
+
+// Retry policy for RPC calls, overridable through RPC_MAX_ATTEMPTS / RPC_BACKOFF_MS
+static int rpcMaxAttempts = 5;
+static int64_t rpcBackoffBaseMs = 500;
+static const int64_t RPC_BACKOFF_CAP_MS = 30000;
+
+/**
+ * Exponential backoff with jitter: base * 2^(attempt-1), capped, plus up to 50% random jitter.
+ */
+static std::chrono::milliseconds backoffDelay(int attempt) {
+    static std::mt19937_64 rng(std::random_device{}());
+    int64_t delay = rpcBackoffBaseMs << std::min(attempt - 1, 16);
+    delay = std::min(delay, RPC_BACKOFF_CAP_MS);
+    std::uniform_int_distribution<int64_t> jitter(0, delay / 2);
+    return std::chrono::milliseconds(delay + jitter(rng));
+}
+
+/**
+ * Run fn(), retrying any exception with exponential backoff. Rethrows after the last attempt.
+ */
+template <typename Fn>
+static auto withRetry(const std::string& what, Fn&& fn) -> decltype(fn()) {
+    for (int attempt = 1; ; attempt++) {
+        try {
+            return fn();
+        } catch (const std::exception& e) {
+            if (attempt >= rpcMaxAttempts) {
+                throw;
+            }
+            auto delay = backoffDelay(attempt);
+            std::cerr << getTimestamp() << "[RETRY] " << what << " failed (attempt " << attempt
+                      << "/" << rpcMaxAttempts << "): " << e.what()
+                      << "; retrying in " << delay.count() << " ms" << std::endl;
+            std::this_thread::sleep_for(delay);
+        }
+    }
+}
+
+// Loop sleep between scans, overridable through POLL_INTERVAL_MS
+static std::chrono::milliseconds pollInterval(60000);
+
+/**
+ * Counters for BENCH_REPORT. Only the main loop thread touches them.
+ */
+struct RunMetrics {
+    std::map<std::string, uint64_t> rpcCalls;   // per JSON-RPC method, retries included
+    uint64_t blocksScanned = 0;
+    uint64_t poolsInserted = 0;
+    std::vector<double> detectionLatencyMs;     // commit time - block timestamp, per new pool
+};
+static RunMetrics metrics;
+
 // cURL write callback
 static size_t WriteCallback(void* contents, size_t size, size_t nmemb, void* userp) {
     ((std::string*)userp)->append((char*)contents, size * nmemb);
@@ -50,6 +151,7 @@ static json quickNodeJsonRpcCall(const std::string& rpcUrl, const json& requestB
     // Convert to string
     std::string requestData = requestBody.dump();
     std::cout << getTimestamp() << "[REQ] " << requestData << std::endl;
+    metrics.rpcCalls[requestBody.value("method", "")]++;
 
     CURL* curl = curl_easy_init();
     if (!curl) {
@@ -70,7 +172,7 @@ static json quickNodeJsonRpcCall(const std::string& rpcUrl, const json& requestB
     if (res != CURLE_OK) {
         curl_easy_cleanup(curl);
         curl_slist_free_all(headers);
-        throw std::runtime_error(std::string("cURL error: ") + curl_easy_strerror(res));
+        throw RpcTransportError(std::string("cURL error: ") + curl_easy_strerror(res));
     }
 
     long httpCode = 0;
@@ -80,7 +182,7 @@ static json quickNodeJsonRpcCall(const std::string& rpcUrl, const json& requestB
     curl_slist_free_all(headers);
 
     if (httpCode < 200 || httpCode >= 300) {
-        throw std::runtime_error("HTTP code=" + std::to_string(httpCode)
+        throw RpcTransportError("HTTP code=" + std::to_string(httpCode)
                                  + ", response=" + responseString);
     }
 
@@ -98,7 +200,7 @@ static json quickNodeJsonRpcCall(const std::string& rpcUrl, const json& requestB
     try {
         resp = json::parse(responseString);
     } catch(const std::exception& e) {
-        throw std::runtime_error("JSON parse error: " + std::string(e.what()));
+        throw RpcTransportError("JSON parse error: " + std::string(e.what()));
     }
     if (resp.contains("error")) {
         throw std::runtime_error("JSON-RPC error: " + resp["error"].dump());
@@ -128,6 +230,7 @@ static std::string callErc20Function(const std::string& rpcUrl,
 
     std::string requestData = requestBody.dump();
     std::cout << getTimestamp() << "[REQ] " << requestData << std::endl;
+    metrics.rpcCalls["eth_call"]++;
 
     CURL* curl = curl_easy_init();
     if (!curl) {
@@ -148,7 +251,7 @@ static std::string callErc20Function(const std::string& rpcUrl,
     if (res != CURLE_OK) {
         curl_easy_cleanup(curl);
         curl_slist_free_all(headers);
-        throw std::runtime_error(std::string("cURL error: ") + curl_easy_strerror(res));
+        throw RpcTransportError(std::string("cURL error: ") + curl_easy_strerror(res));
     }
 
     long httpCode = 0;
@@ -157,7 +260,7 @@ static std::string callErc20Function(const std::string& rpcUrl,
     curl_slist_free_all(headers);
 
     if (httpCode < 200 || httpCode >= 300) {
-        throw std::runtime_error("HTTP code=" + std::to_string(httpCode)
+        throw RpcTransportError("HTTP code=" + std::to_string(httpCode)
                                  + ", response=" + responseString);
     }
 
@@ -172,7 +275,7 @@ static std::string callErc20Function(const std::string& rpcUrl,
     try {
         jsonResp = json::parse(responseString);
     } catch(const std::exception& e) {
-        throw std::runtime_error("JSON parse error: " + std::string(e.what()));
+        throw RpcTransportError("JSON parse error: " + std::string(e.what()));
     }
     if (jsonResp.contains("error")) {
         throw std::runtime_error("JSON-RPC error: " + jsonResp["error"].dump());
@@ -183,84 +286,40 @@ static std::string callErc20Function(const std::string& rpcUrl,
     return jsonResp["result"].get<std::string>();
 }
 
+
 /**
- * decode typical ABI-encoded string
+ * Call a string getter and decode it. A JSON-RPC error (revert, missing method) means the
+ * token simply has no such getter and yields "", transport failures are retried and rethrown.
  */
-static std::string decodeStringFromHex(const std::string& hexData) {
-    if (hexData.size() < 2 || hexData.rfind("0x", 0) != 0) {
-        return "";
-    }
-    std::string raw = hexData.substr(2);
-
-    if (raw.size() < 128) {
-        return "";
-    }
-
-    uint64_t length = std::stoull(raw.substr(64, 64), nullptr, 16);
-    if (length > 1000) {
-        return "";
-    }
-
-    size_t dataStart = 128;
-    size_t stringHexLen = length * 2;
-    if (dataStart + stringHexLen > raw.size()) {
-        return "";
-    }
-
-    std::string hexStringBytes = raw.substr(dataStart, stringHexLen);
-    std::string result;
-    result.reserve(length);
-
-    for (size_t i = 0; i < stringHexLen; i += 2) {
-        std::string byteStr = hexStringBytes.substr(i, 2);
-        char c = static_cast<char>(std::stoi(byteStr, nullptr, 16));
-        result.push_back(c);
-    }
-    return result;
-}
-
-static std::string getErc20Symbol(const std::string& rpcUrl, const std::string& tokenAddress) {
+static std::string callErc20String(const std::string& rpcUrl,
+                                   const std::string& tokenAddress,
+                                   const std::string& hexSelector)
+{
+    std::string hexResult = withRetry("eth_call " + hexSelector + " on " + tokenAddress, [&]() {
+        try {
+            return callErc20Function(rpcUrl, tokenAddress, hexSelector);
+        } catch (const RpcTransportError&) {
+            throw;
+        } catch (const std::exception&) {
+            return std::string();
+        }
+    });
     try {
-        std::string hexResult = callErc20Function(rpcUrl, tokenAddress, "0x95d89b41");
         return decodeStringFromHex(hexResult);
-    } catch(...) {
+    } catch (...) {
         return "";
     }
 }
 
-static std::string getErc20Name(const std::string& rpcUrl, const std::string& tokenAddress) {
-    try {
-        std::string hexResult = callErc20Function(rpcUrl, tokenAddress, "0x06fdde03");
-        return decodeStringFromHex(hexResult);
-    } catch(...) {
-        return "";
-    }
+static std::string getErc20Symbol(const std::string& rpcUrl, const std::string& tokenAddress) {
+    return callErc20String(rpcUrl, tokenAddress, "0x95d89b41");
 }
 
-static std::string decimalToHex(int64_t blockNum) {
-    std::ostringstream ss;
-    ss << "0x" << std::hex << blockNum;
-    return ss.str();
+static std::string getErc20Name(const std::string& rpcUrl, const std::string& tokenAddress) {
+    return callErc20String(rpcUrl, tokenAddress, "0x06fdde03");
 }
 
-// Uniswap V2 => PairCreated => "0x0d3648bd..."
-// Uniswap V3 => PoolCreated => "0x783cca1c..."
-static const std::string V2_SIG = keccak256("PairCreated(address,address,address,uint256)");
-static const std::string V3_SIG = keccak256("PoolCreated(address,address,uint24,int24,address)");
 
-struct DexDefinition {
-    std::string dexName;
-    std::string factoryAddress;
-    bool isV2Style;
-};
-
-// We'll handle UniswapV2, SushiSwap, UniswapV3, PancakeSwap
-static std::vector<DexDefinition> DEXES = {
-    {"UniswapV2",   "0x5C69Bee701EF814A2B6a3EDD4B1652CB9cc5aA6f", true},
-    {"SushiSwap",   "0xC0AEe478e3658e2610c5F7A4A2E1777Ce9e4f2Ac", true},
-    {"UniswapV3",   "0x1F98431c8aD98523631AE4a59f267346ea31F984", false},
-    {"PancakeSwap", "0xca143ce32fe78f1f7019d7d551a6402fc5350c73", true}
-};
 
 /**
  * Query logs for one DEX in a block range
@@ -302,15 +361,7 @@ static std::vector<json> getDexLogs(const std::string& rpcUrl,
     return logs;
 }
 
-/**
- * Convert last 20 bytes from a zero-padded 32-byte => "0x..."
- */
-static std::string topicToAddress(const std::string& topic) {
-    if (topic.size() < 66) {
-        return "";
-    }
-    return "0x" + topic.substr(topic.size() - 40);
-}
+
 
 /**
  * get block timestamp as an integer of seconds, then convert to SQL timestamp using to_timestamp
@@ -362,9 +413,10 @@ static void saveLastBlockProcessed(pqxx::connection& conn, const std::string& bl
 }
 
 /**
- * Insert or update liquidity_pools, storing block_timestamp as a SQL TIMESTAMP
+ * Insert or update liquidity_pools, storing block_timestamp as a SQL TIMESTAMP.
+ * Returns true if the pool was not in the table before.
  */
-static void insertLiquidityPool(pqxx::connection& conn,
+static bool insertLiquidityPool(pqxx::connection& conn,
                                 const std::string& dexName,
                                 const std::string& poolAddress,
                                 const std::string& token0,
@@ -415,11 +467,12 @@ static void insertLiquidityPool(pqxx::connection& conn,
           tick_spacing     = EXCLUDED.tick_spacing,
           block_discovered = EXCLUDED.block_discovered,
           block_timestamp  = EXCLUDED.block_timestamp
+        RETURNING (xmax = 0) AS inserted
     )SQL";
 
     // We'll pass blockTimestampEpoch as param #12 (int64 => double precision).
     pqxx::work txn(conn);
-    txn.exec_params(
+    auto r = txn.exec_params(
         sql,
         poolAddress,
         dexName,
@@ -435,9 +488,855 @@ static void insertLiquidityPool(pqxx::connection& conn,
         (double)blockTimestampEpoch // cast to double
     );
     txn.commit();
+    return r.size() == 1 && r[0]["inserted"].as<bool>();
 }
 
-int main() {
+/**
+ * Journal lookup: end block already scanned for (rangeStart, dex), or -1 if none
+ */
+static int64_t loadJournaledRangeEnd(pqxx::connection& conn, int64_t rangeStart, const std::string& dexName) {
+    pqxx::work txn(conn);
+    auto r = txn.exec_params(
+        "SELECT range_end FROM scan_journal WHERE range_start=$1 AND dex_name=$2",
+        rangeStart, dexName);
+    txn.commit();
+    if (r.size() == 1 && !r[0]["range_end"].is_null()) {
+        return r[0]["range_end"].as<int64_t>();
+    }
+    return -1;
+}
+
+/**
+ * Record that all logs of one DEX in [rangeStart, rangeEnd] were handled
+ */
+static void saveJournalEntry(pqxx::connection& conn, int64_t rangeStart, const std::string& dexName, int64_t rangeEnd) {
+    static const char* upsertSQL = R"SQL(
+        INSERT INTO scan_journal (range_start, dex_name, range_end, completed_at)
+        VALUES ($1, $2, $3, now())
+        ON CONFLICT (range_start, dex_name) DO UPDATE
+          SET range_end    = EXCLUDED.range_end,
+              completed_at = EXCLUDED.completed_at
+    )SQL";
+
+    pqxx::work txn(conn);
+    txn.exec_params(upsertSQL, rangeStart, dexName, rangeEnd);
+    txn.commit();
+}
+
+/**
+ * Move the checkpoint to blockNum and drop journal entries it now covers, in one transaction
+ */
+static void advanceCheckpoint(pqxx::connection& conn, int64_t blockNum) {
+    static const char* upsertSQL = R"SQL(
+        INSERT INTO block_info (id, last_block_processed)
+        VALUES (1, $1)
+        ON CONFLICT (id) DO UPDATE
+          SET last_block_processed = EXCLUDED.last_block_processed
+    )SQL";
+
+    pqxx::work txn(conn);
+    txn.exec_params(upsertSQL, decimalToHex(blockNum));
+    txn.exec_params("DELETE FROM scan_journal WHERE range_start <= $1", blockNum);
+    txn.commit();
+}
+
+/**
+ * Queue a pool whose enrichment failed. Each failure doubles the wait before the next
+ * attempt (60s, 120s, ... capped at 6h).
+ */
+static void recordPoolEnrichmentFailure(pqxx::connection& conn, const PoolRecord& rec, const std::string& error) {
+    static const char* upsertSQL = R"SQL(
+        INSERT INTO pool_enrichment_queue (
+          pool_address,
+          dex_name,
+          token0_address,
+          token1_address,
+          fee,
+          tick_spacing,
+          block_discovered,
+          attempts,
+          next_attempt_at,
+          last_error
+        )
+        VALUES ($1, $2, $3, $4, $5, $6, $7, 1, now() + interval '60 seconds', $8)
+        ON CONFLICT (pool_address) DO UPDATE
+        SET
+          attempts        = pool_enrichment_queue.attempts + 1,
+          next_attempt_at = now() + LEAST(21600, 60 * power(2, pool_enrichment_queue.attempts)) * interval '1 second',
+          last_error      = EXCLUDED.last_error
+    )SQL";
+
+    pqxx::work txn(conn);
+    txn.exec_params(
+        upsertSQL,
+        rec.poolAddress,
+        rec.dexName,
+        rec.token0,
+        rec.token1,
+        rec.fee,
+        rec.tickSpacing,
+        rec.blockHex,
+        error
+    );
+    txn.commit();
+}
+
+static void removeQueuedPool(pqxx::connection& conn, const std::string& poolAddress) {
+    pqxx::work txn(conn);
+    txn.exec_params("DELETE FROM pool_enrichment_queue WHERE pool_address=$1", poolAddress);
+    txn.commit();
+}
+
+// Push feed for newly inserted pools, enabled by FEED_SOCKET_PATH / FEED_SHM_NAME
+static std::unique_ptr<PoolFeed> poolFeed;
+
+// In-memory token => pools index, enabled by INDEX_SOCKET_PATH
+static std::unique_ptr<PoolIndex> poolIndex;
+static std::unique_ptr<PoolIndexServer> poolIndexServer;
+
+static void publishNewPool(const PoolRecord& rec, int64_t blockTimestampEpoch) {
+    PoolFeedRecord out{};
+    out.blockNumber = std::stoll(rec.blockHex.substr(2), nullptr, 16);
+    out.blockTimestamp = blockTimestampEpoch;
+    out.fee = (uint32_t)rec.fee;
+    out.tickSpacing = rec.tickSpacing;
+    out.dexId = dexIdFor(rec.dexName);
+    if (!addressFromHex(rec.poolAddress, out.pool)
+        || !addressFromHex(rec.token0, out.token0)
+        || !addressFromHex(rec.token1, out.token1)) {
+        std::cerr << getTimestamp() << "[WARN] Not publishing pool with malformed address "
+                  << rec.poolAddress << std::endl;
+        return;
+    }
+    poolFeed->publish(out);
+}
+
+static void indexPool(const PoolRecord& rec,
+                      const std::string& t0Symbol, const std::string& t0Name,
+                      const std::string& t1Symbol, const std::string& t1Name)
+{
+    IndexedPool entry{};
+    entry.blockNumber = rec.blockHex.size() > 2 ? std::stoll(rec.blockHex.substr(2), nullptr, 16) : 0;
+    entry.fee = (uint32_t)rec.fee;
+    entry.tickSpacing = rec.tickSpacing;
+    entry.dexId = dexIdFor(rec.dexName);
+    if (!addressFromHex(rec.poolAddress, entry.pool)
+        || !addressFromHex(rec.token0, entry.token0)
+        || !addressFromHex(rec.token1, entry.token1)) {
+        return;
+    }
+    poolIndex->upsertPool(entry, t0Symbol, t0Name, t1Symbol, t1Name);
+}
+
+/**
+ * Build the index from liquidity_pools at startup
+ */
+static void loadPoolIndex(pqxx::connection& conn) {
+    pqxx::work txn(conn);
+    auto r = txn.exec(R"SQL(
+        SELECT pool_address, dex_name, token0_address, token1_address,
+               token0_symbol, token0_name, token1_symbol, token1_name,
+               fee, tick_spacing, block_discovered
+        FROM liquidity_pools
+    )SQL");
+    txn.commit();
+
+    for (const auto& row : r) {
+        PoolRecord rec;
+        rec.poolAddress = row["pool_address"].as<std::string>();
+        rec.dexName     = row["dex_name"].as<std::string>("");
+        rec.token0      = row["token0_address"].as<std::string>("");
+        rec.token1      = row["token1_address"].as<std::string>("");
+        rec.fee         = row["fee"].as<int>(0);
+        rec.tickSpacing = row["tick_spacing"].as<int>(0);
+        rec.blockHex    = row["block_discovered"].as<std::string>("");
+        indexPool(rec,
+                  row["token0_symbol"].as<std::string>(""), row["token0_name"].as<std::string>(""),
+                  row["token1_symbol"].as<std::string>(""), row["token1_name"].as<std::string>(""));
+    }
+}
+
+/**
+ * Fetch block timestamp and token metadata for a decoded pool, then upsert it.
+ * Throws once RPC retries are exhausted.
+ */
+static void enrichAndStorePool(pqxx::connection& conn, const std::string& rpcUrl, const PoolRecord& rec) {
+    int64_t blockTimestampEpoch = withRetry("eth_getBlockByNumber " + rec.blockHex, [&]() {
+        return getBlockTimestamp(rpcUrl, rec.blockHex);
+    });
+
+    std::string t0Symbol = getErc20Symbol(rpcUrl, rec.token0);
+    std::string t0Name   = getErc20Name(rpcUrl, rec.token0);
+    std::string t1Symbol = getErc20Symbol(rpcUrl, rec.token1);
+    std::string t1Name   = getErc20Name(rpcUrl, rec.token1);
+
+    bool inserted = insertLiquidityPool(
+        conn,
+        rec.dexName,
+        rec.poolAddress,
+        rec.token0,
+        rec.token1,
+        t0Symbol,
+        t0Name,
+        t1Symbol,
+        t1Name,
+        rec.fee,
+        rec.tickSpacing,
+        rec.blockHex,
+        blockTimestampEpoch
+    );
+
+    if (inserted) {
+        metrics.poolsInserted++;
+        if (blockTimestampEpoch > 0) {
+            auto nowMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+            metrics.detectionLatencyMs.push_back((double)(nowMs - blockTimestampEpoch * 1000));
+        }
+    }
+    if (poolIndex) {
+        indexPool(rec, t0Symbol, t0Name, t1Symbol, t1Name);
+    }
+    if (inserted && poolFeed) {
+        publishNewPool(rec, blockTimestampEpoch);
+    }
+}
+
+/**
+ * Enrich and store a pool; on failure park it in pool_enrichment_queue so the scan can move on
+ */
+static void processPool(pqxx::connection& conn, const std::string& rpcUrl, const PoolRecord& rec) {
+    try {
+        enrichAndStorePool(conn, rpcUrl, rec);
+    } catch (const std::exception& e) {
+        std::cerr << getTimestamp() << "[ERROR] Enrichment failed for pool " << rec.poolAddress
+                  << ", queued for retry: " << e.what() << std::endl;
+        recordPoolEnrichmentFailure(conn, rec, e.what());
+    }
+}
+
+static const int ENRICHMENT_BATCH = 100;
+
+/**
+ * Run enrichment for queued pools that are due (bulk-ingested or backing off after a failure).
+ * The batch is claimed by pushing next_attempt_at 5 minutes out, so concurrent instances
+ * don't pick the same pools. Returns how many were picked up.
+ */
+static int retryQueuedPools(pqxx::connection& conn, const std::string& rpcUrl) {
+    pqxx::work txn(conn);
+    auto r = txn.exec_params(R"SQL(
+        UPDATE pool_enrichment_queue
+        SET next_attempt_at = now() + interval '5 minutes'
+        WHERE pool_address IN (
+          SELECT pool_address
+          FROM pool_enrichment_queue
+          WHERE next_attempt_at <= now()
+          ORDER BY next_attempt_at
+          LIMIT $1
+          FOR UPDATE SKIP LOCKED
+        )
+        RETURNING pool_address, dex_name, token0_address, token1_address,
+                  fee, tick_spacing, block_discovered
+    )SQL", ENRICHMENT_BATCH);
+    txn.commit();
+
+    for (const auto& row : r) {
+        PoolRecord rec;
+        rec.poolAddress = row["pool_address"].as<std::string>();
+        rec.dexName     = row["dex_name"].as<std::string>("");
+        rec.token0      = row["token0_address"].as<std::string>("");
+        rec.token1      = row["token1_address"].as<std::string>("");
+        rec.fee         = row["fee"].as<int>(0);
+        rec.tickSpacing = row["tick_spacing"].as<int>(0);
+        rec.blockHex    = row["block_discovered"].as<std::string>("");
+
+        try {
+            enrichAndStorePool(conn, rpcUrl, rec);
+            removeQueuedPool(conn, rec.poolAddress);
+            std::cout << getTimestamp() << "Enriched queued pool " << rec.poolAddress << std::endl;
+        } catch (const std::exception& e) {
+            std::cerr << getTimestamp() << "[ERROR] Retry failed for pool " << rec.poolAddress
+                      << ": " << e.what() << std::endl;
+            recordPoolEnrichmentFailure(conn, rec, e.what());
+        }
+    }
+    return (int)r.size();
+}
+
+static const int64_t CHUNK_SIZE = 10000;
+
+/**
+ * Scan [rangeStart, rangeEnd] for every DEX, skipping whatever the journal says is already done
+ */
+static void scanRange(pqxx::connection& conn, const std::string& rpcUrl, int64_t rangeStart, int64_t rangeEnd) {
+    for (auto& dex : DEXES) {
+        int64_t scanFrom = rangeStart;
+        int64_t journaledEnd = loadJournaledRangeEnd(conn, rangeStart, dex.dexName);
+        if (journaledEnd >= rangeEnd) {
+            continue;
+        }
+        if (journaledEnd >= rangeStart) {
+            scanFrom = journaledEnd + 1;
+        }
+
+        auto logs = withRetry("eth_getLogs " + dex.dexName, [&]() {
+            return getDexLogs(rpcUrl, dex, scanFrom, rangeEnd);
+        });
+
+        for (auto& logEntry : logs) {
+            PoolRecord rec;
+            std::string error;
+            if (!decodePoolLog(dex, logEntry, rec, &error)) {
+                if (!error.empty()) {
+                    std::cerr << getTimestamp() << "[WARN] Skipping malformed " << dex.dexName
+                              << " log: " << error << std::endl;
+                }
+                continue;
+            }
+            processPool(conn, rpcUrl, rec);
+        }
+
+        saveJournalEntry(conn, rangeStart, dex.dexName, rangeEnd);
+    }
+}
+
+// Where a fresh database starts scanning: ~7 days => ~50400 blocks
+static const int64_t BOOTSTRAP_LOOKBACK_BLOCKS = 50400;
+
+// Serializes work unit planning and watermark updates across instances
+static const int64_t WORK_UNITS_LOCK_KEY = 0x746f6b656e66; // "tokenf"
+
+/**
+ * Split (highest planned block, latestBlock] into CHUNK_SIZE work units. Planning resumes
+ * from the last planned unit, or from last_block_processed when none are left. On a fresh
+ * database block_info is first set to BOOTSTRAP_LOOKBACK_BLOCKS before latestBlock, under
+ * the same lock, so instances starting together agree on where to begin.
+ */
+static void planWorkUnits(pqxx::connection& conn, int64_t latestBlock) {
+    pqxx::work txn(conn);
+    txn.exec_params("SELECT pg_advisory_xact_lock($1::bigint)", WORK_UNITS_LOCK_KEY);
+
+    auto r = txn.exec(R"SQL(
+        SELECT (SELECT max(range_end) FROM scan_work_units) AS planned_end,
+               (SELECT last_block_processed FROM block_info WHERE id=1) AS last_block
+    )SQL");
+    int64_t nextStart;
+    if (!r[0]["planned_end"].is_null()) {
+        nextStart = r[0]["planned_end"].as<int64_t>() + 1;
+    } else {
+        std::string lastBlockHex = r[0]["last_block"].as<std::string>("0x0");
+        if (lastBlockHex == "0x0") {
+            lastBlockHex = decimalToHex(std::max<int64_t>(0, latestBlock - BOOTSTRAP_LOOKBACK_BLOCKS));
+            txn.exec_params(R"SQL(
+                INSERT INTO block_info (id, last_block_processed)
+                VALUES (1, $1)
+                ON CONFLICT (id) DO UPDATE
+                  SET last_block_processed = EXCLUDED.last_block_processed
+            )SQL", lastBlockHex);
+            std::cout << getTimestamp() << "Set last block to ~7 days ago: " << lastBlockHex << std::endl;
+        }
+        nextStart = std::stoll(lastBlockHex.substr(2), nullptr, 16) + 1;
+    }
+
+    int planned = 0;
+    for (int64_t start = nextStart; start <= latestBlock; start += CHUNK_SIZE) {
+        int64_t end = std::min(start + CHUNK_SIZE - 1, latestBlock);
+        txn.exec_params(R"SQL(
+            INSERT INTO scan_work_units (range_start, range_end, status)
+            VALUES ($1, $2, 'pending')
+            ON CONFLICT (range_start) DO NOTHING
+        )SQL", start, end);
+        planned++;
+    }
+    txn.commit();
+
+    if (planned > 0) {
+        std::cout << getTimestamp() << "Planned " << planned << " work units from block "
+                  << nextStart << " to " << latestBlock << std::endl;
+    }
+}
+
+struct WorkUnit {
+    int64_t rangeStart;
+    int64_t rangeEnd;
+};
+
+/**
+ * Lease the lowest pending or expired unit. Returns false when nothing is claimable.
+ */
+static bool claimWorkUnit(pqxx::connection& conn, const std::string& owner, int leaseSeconds, WorkUnit& unit) {
+    pqxx::work txn(conn);
+    auto r = txn.exec_params(R"SQL(
+        UPDATE scan_work_units
+        SET status = 'claimed',
+            owner = $1,
+            lease_expires_at = now() + $2::int * interval '1 second',
+            attempts = attempts + 1
+        WHERE range_start = (
+          SELECT range_start
+          FROM scan_work_units
+          WHERE status = 'pending'
+             OR (status = 'claimed' AND lease_expires_at < now())
+          ORDER BY range_start
+          LIMIT 1
+          FOR UPDATE SKIP LOCKED
+        )
+        RETURNING range_start, range_end
+    )SQL", owner, leaseSeconds);
+    txn.commit();
+    if (r.size() != 1) {
+        return false;
+    }
+    unit.rangeStart = r[0]["range_start"].as<int64_t>();
+    unit.rangeEnd = r[0]["range_end"].as<int64_t>();
+    return true;
+}
+
+/**
+ * Mark a unit done, or hand it back as pending after a failure. Returns false if the lease
+ * had already passed to another instance.
+ */
+static bool finishWorkUnit(pqxx::connection& conn, const WorkUnit& unit, const std::string& owner, bool done) {
+    pqxx::work txn(conn);
+    auto r = txn.exec_params(R"SQL(
+        UPDATE scan_work_units
+        SET status = CASE WHEN $3::boolean THEN 'done' ELSE 'pending' END,
+            owner = CASE WHEN $3::boolean THEN owner ELSE NULL END,
+            lease_expires_at = NULL,
+            completed_at = CASE WHEN $3::boolean THEN now() ELSE NULL END
+        WHERE range_start = $1 AND owner = $2 AND status = 'claimed'
+    )SQL", unit.rangeStart, owner, done);
+    txn.commit();
+    return r.affected_rows() == 1;
+}
+
+/**
+ * Move block_info to the end of the contiguous run of done units, then drop those units
+ * and the journal entries they cover. Returns the watermark, or -1 if nothing is planned.
+ */
+static int64_t advanceWatermark(pqxx::connection& conn) {
+    pqxx::work txn(conn);
+    txn.exec_params("SELECT pg_advisory_xact_lock($1::bigint)", WORK_UNITS_LOCK_KEY);
+
+    auto r = txn.exec(R"SQL(
+        SELECT COALESCE(
+          (SELECT min(range_start) - 1 FROM scan_work_units WHERE status <> 'done'),
+          (SELECT max(range_end) FROM scan_work_units)
+        ) AS watermark
+    )SQL");
+    if (r[0]["watermark"].is_null()) {
+        txn.commit();
+        return -1;
+    }
+    int64_t watermark = r[0]["watermark"].as<int64_t>();
+
+    auto done = txn.exec_params(
+        "DELETE FROM scan_work_units WHERE status = 'done' AND range_end <= $1", watermark);
+    if (done.affected_rows() > 0) {
+        txn.exec_params(R"SQL(
+            INSERT INTO block_info (id, last_block_processed)
+            VALUES (1, $1)
+            ON CONFLICT (id) DO UPDATE
+              SET last_block_processed = EXCLUDED.last_block_processed
+        )SQL", decimalToHex(watermark));
+        txn.exec_params("DELETE FROM scan_journal WHERE range_start <= $1", watermark);
+    }
+    txn.commit();
+    return watermark;
+}
+
+/**
+ * Extends a work unit lease from its own connection until destroyed
+ */
+class LeaseHeartbeat {
+public:
+    LeaseHeartbeat(const std::string& connStr, const WorkUnit& unit, const std::string& owner, int leaseSeconds)
+        : thread_([this, connStr, unit, owner, leaseSeconds]() { run(connStr, unit, owner, leaseSeconds); })
+    {
+    }
+
+    ~LeaseHeartbeat() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        thread_.join();
+    }
+
+private:
+    void run(const std::string& connStr, const WorkUnit& unit, const std::string& owner, int leaseSeconds) {
+        auto interval = std::chrono::seconds(std::max(1, leaseSeconds / 3));
+        try {
+            pqxx::connection hbConn(connStr);
+            std::unique_lock<std::mutex> lock(mutex_);
+            while (!wake_.wait_for(lock, interval, [this] { return stopping_; })) {
+                pqxx::work txn(hbConn);
+                auto r = txn.exec_params(R"SQL(
+                    UPDATE scan_work_units
+                    SET lease_expires_at = now() + $3::int * interval '1 second'
+                    WHERE range_start = $1 AND owner = $2 AND status = 'claimed'
+                )SQL", unit.rangeStart, owner, leaseSeconds);
+                txn.commit();
+                if (r.affected_rows() != 1) {
+                    std::cerr << getTimestamp() << "[WARN] Lease on unit " << unit.rangeStart
+                              << " was taken over" << std::endl;
+                    return;
+                }
+            }
+        } catch (const std::exception& e) {
+            std::cerr << getTimestamp() << "[ERROR] Heartbeat for unit " << unit.rangeStart
+                      << " failed: " << e.what() << std::endl;
+        }
+    }
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    bool stopping_ = false;
+    std::thread thread_;
+};
+
+/**
+ * Coordinated mode: any number of instances share the scan through scan_work_units leases,
+ * and block_info follows the contiguous watermark of completed units.
+ */
+static void runCoordinated(pqxx::connection& conn, const std::string& connStr, const std::string& rpcUrl,
+                           const std::string& instanceId, int leaseSeconds, int64_t stopAtBlock)
+{
+    std::cout << getTimestamp() << "Coordinated mode as " << instanceId
+              << ", lease " << leaseSeconds << "s" << std::endl;
+
+    while (true) {
+        bool enrichmentBacklog = false;
+        try {
+            enrichmentBacklog = retryQueuedPools(conn, rpcUrl) == ENRICHMENT_BATCH;
+
+            json req = {
+                {"jsonrpc", "2.0"},
+                {"id", 1},
+                {"method", "eth_blockNumber"},
+                {"params", json::array()}
+            };
+            json resp = withRetry("eth_blockNumber", [&]() {
+                return quickNodeJsonRpcCall(rpcUrl, req);
+            });
+            std::string latestHex = resp["result"].get<std::string>();
+            planWorkUnits(conn, std::stoll(latestHex.substr(2), nullptr, 16));
+
+            WorkUnit unit;
+            while (claimWorkUnit(conn, instanceId, leaseSeconds, unit)) {
+                std::cout << getTimestamp() << "Claimed unit " << unit.rangeStart
+                          << " to " << unit.rangeEnd << std::endl;
+                try {
+                    LeaseHeartbeat heartbeat(connStr, unit, instanceId, leaseSeconds);
+                    scanRange(conn, rpcUrl, unit.rangeStart, unit.rangeEnd);
+                }
+                catch (...) {
+                    // Release right away instead of making others wait for the lease to expire
+                    finishWorkUnit(conn, unit, instanceId, false);
+                    throw;
+                }
+                if (finishWorkUnit(conn, unit, instanceId, true)) {
+                    metrics.blocksScanned += unit.rangeEnd - unit.rangeStart + 1;
+                } else {
+                    std::cerr << getTimestamp() << "[WARN] Unit " << unit.rangeStart
+                              << " finished after its lease moved to another instance" << std::endl;
+                }
+
+                int64_t watermark = advanceWatermark(conn);
+                std::cout << getTimestamp() << "Finished unit " << unit.rangeStart << " to "
+                          << unit.rangeEnd << ", watermark " << watermark << std::endl;
+            }
+            advanceWatermark(conn);
+
+            // Every instance stops once the shared watermark passes stopAtBlock
+            if (stopAtBlock >= 0) {
+                std::string lastBlockHex = loadLastBlockProcessed(conn);
+                if (std::stoll(lastBlockHex.substr(2), nullptr, 16) >= stopAtBlock) {
+                    std::cout << getTimestamp() << "Reached STOP_AT_BLOCK " << stopAtBlock << std::endl;
+                    return;
+                }
+            }
+        }
+        catch (const std::exception& e) {
+            std::cerr << getTimestamp() << "[ERROR] " << e.what() << std::endl;
+        }
+
+        if (enrichmentBacklog) {
+            continue;
+        }
+
+        std::cout << getTimestamp() << "Sleeping " << pollInterval.count() << " ms..." << std::endl;
+        std::this_thread::sleep_for(pollInterval);
+    }
+}
+
+/**
+ * Default mode: this instance owns block_info and scans everything after it. Returns once
+ * stopAtBlock (if >= 0) is processed.
+ */
+static void runSingleInstance(pqxx::connection& conn, const std::string& rpcUrl,
+                              std::string lastBlockHex, int64_t stopAtBlock)
+{
+    while (true) {
+        bool enrichmentBacklog = false;
+        try {
+            enrichmentBacklog = retryQueuedPools(conn, rpcUrl) == ENRICHMENT_BATCH;
+
+            // last_block_processed is inclusive, resume right after it
+            int64_t fromBlock = std::stoll(lastBlockHex.substr(2), nullptr, 16) + 1;
+
+            // get latest
+            json req = {
+                {"jsonrpc", "2.0"},
+                {"id", 1},
+                {"method", "eth_blockNumber"},
+                {"params", json::array()}
+            };
+            json resp = withRetry("eth_blockNumber", [&]() {
+                return quickNodeJsonRpcCall(rpcUrl, req);
+            });
+            std::string latestHex = resp["result"].get<std::string>();
+            int64_t latestBlock = std::stoll(latestHex.substr(2), nullptr, 16);
+
+            if (latestBlock < fromBlock) {
+                std::cout << getTimestamp() << "No new blocks to process." << std::endl;
+            } else {
+                std::cout << getTimestamp() << "Scanning from block "
+                          << fromBlock << " to " << latestBlock << std::endl;
+
+                int64_t currentBlock = fromBlock;
+
+                while (currentBlock <= latestBlock) {
+                    int64_t endBlock = std::min(currentBlock + CHUNK_SIZE - 1, latestBlock);
+
+                    scanRange(conn, rpcUrl, currentBlock, endBlock);
+
+                    // Advance even when the chunk was empty, so a later failure never rescans it
+                    advanceCheckpoint(conn, endBlock);
+                    metrics.blocksScanned += endBlock - currentBlock + 1;
+                    lastBlockHex = decimalToHex(endBlock);
+                    std::cout << getTimestamp() << "Updated last block to "
+                              << lastBlockHex << std::endl;
+
+                    currentBlock = endBlock + 1;
+                }
+            }
+        }
+        catch (const std::exception& e) {
+            std::cerr << getTimestamp() << "[ERROR] " << e.what() << std::endl;
+        }
+
+        if (stopAtBlock >= 0 && std::stoll(lastBlockHex.substr(2), nullptr, 16) >= stopAtBlock) {
+            std::cout << getTimestamp() << "Reached STOP_AT_BLOCK " << stopAtBlock << std::endl;
+            break;
+        }
+
+        if (enrichmentBacklog) {
+            // More queued pools are due, e.g. after --ingest; keep going instead of idling
+            continue;
+        }
+
+        std::cout << getTimestamp() << "Sleeping " << pollInterval.count() << " ms..." << std::endl;
+        std::this_thread::sleep_for(pollInterval);
+    }
+}
+
+/**
+ * Write throughput, RPC cost and detection latency of this run as JSON
+ */
+static void writeBenchReport(const std::string& path, double elapsedSeconds) {
+    uint64_t rpcTotal = 0;
+    json rpcCalls = json::object();
+    for (const auto& kv : metrics.rpcCalls) {
+        rpcCalls[kv.first] = kv.second;
+        rpcTotal += kv.second;
+    }
+    std::vector<double> latencies = metrics.detectionLatencyMs;
+    std::sort(latencies.begin(), latencies.end());
+
+    json report = {
+        {"elapsed_s", elapsedSeconds},
+        {"blocks", metrics.blocksScanned},
+        {"pools", metrics.poolsInserted},
+        {"blocks_per_s", elapsedSeconds > 0 ? metrics.blocksScanned / elapsedSeconds : 0.0},
+        {"pools_per_s", elapsedSeconds > 0 ? metrics.poolsInserted / elapsedSeconds : 0.0},
+        {"rpc_calls", rpcCalls},
+        {"rpc_calls_total", rpcTotal},
+        {"rpc_calls_per_pool", metrics.poolsInserted ? (double)rpcTotal / metrics.poolsInserted : 0.0},
+        {"detection_latency_ms", {
+            {"samples", latencies.size()},
+            {"p50", percentileOfSorted(latencies, 0.50)},
+            {"p99", percentileOfSorted(latencies, 0.99)}
+        }}
+    };
+
+    std::ofstream out(path);
+    out << report.dump(2) << std::endl;
+    if (!out) {
+        std::cerr << getTimestamp() << "[ERROR] Could not write bench report to " << path << std::endl;
+    }
+}
+
+/**
+ * Bulk-load ingested pools without token metadata. Newly inserted pools are queued in
+ * pool_enrichment_queue so the main loop fills in symbol/name; pools already present are left alone.
+ */
+static void bulkLoadIngestedPools(pqxx::connection& conn, const IngestResult& ingest) {
+    const size_t batchSize = 1000;
+    size_t inserted = 0;
+
+    pqxx::work txn(conn);
+    for (size_t i = 0; i < ingest.pools.size(); i += batchSize) {
+        std::ostringstream values;
+        size_t end = std::min(ingest.pools.size(), i + batchSize);
+        for (size_t j = i; j < end; j++) {
+            const PoolRecord& rec = ingest.pools[j];
+            int64_t blockDec = std::stoll(rec.blockHex.substr(2), nullptr, 16);
+            auto ts = ingest.blockTimestamps.find(blockDec);
+            int64_t blockTimestampEpoch = (ts == ingest.blockTimestamps.end()) ? 0 : ts->second;
+
+            values << (j == i ? "" : ",\n") << "("
+                   << txn.quote(rec.poolAddress) << ", "
+                   << txn.quote(rec.dexName) << ", "
+                   << txn.quote(rec.token0) << ", "
+                   << txn.quote(rec.token1) << ", '', '', '', '', "
+                   << rec.fee << ", "
+                   << rec.tickSpacing << ", "
+                   << txn.quote(rec.blockHex) << ", "
+                   << "to_timestamp(" << blockTimestampEpoch << "))";
+        }
+
+        auto r = txn.exec(R"SQL(
+            WITH ins AS (
+              INSERT INTO liquidity_pools (
+                pool_address, dex_name, token0_address, token1_address,
+                token0_symbol, token0_name, token1_symbol, token1_name,
+                fee, tick_spacing, block_discovered, block_timestamp
+              )
+              VALUES )SQL" + values.str() + R"SQL(
+              ON CONFLICT (pool_address) DO NOTHING
+              RETURNING pool_address, dex_name, token0_address, token1_address,
+                        fee, tick_spacing, block_discovered
+            )
+            INSERT INTO pool_enrichment_queue (
+              pool_address, dex_name, token0_address, token1_address,
+              fee, tick_spacing, block_discovered, attempts, next_attempt_at
+            )
+            SELECT pool_address, dex_name, token0_address, token1_address,
+                   fee, tick_spacing, block_discovered, 0, now()
+            FROM ins
+            ON CONFLICT (pool_address) DO NOTHING
+        )SQL");
+        inserted += r.affected_rows();
+    }
+    txn.commit();
+
+    if (poolIndex) {
+        for (const PoolRecord& rec : ingest.pools) {
+            indexPool(rec, "", "", "", "");
+        }
+    }
+
+    std::cout << getTimestamp() << "Bulk-loaded " << inserted << " new pools of "
+              << ingest.pools.size() << " decoded" << std::endl;
+}
+
+/**
+ * --ingest mode: load pools from local dumps, then move the checkpoint to the end of the dump's
+ * block range so the RPC loop picks up right after it. The range is [fromBlock, toBlock] when
+ * given (fromBlock >= 0), otherwise the span of the dump's block headers.
+ */
+static void runIngest(pqxx::connection& conn, const std::vector<std::string>& files,
+                      int64_t fromBlock, int64_t toBlock, std::string& lastBlockHex)
+{
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    std::cout << getTimestamp() << "Ingesting " << files.size() << " dump file(s) on "
+              << threads << " threads" << std::endl;
+
+    auto started = std::chrono::steady_clock::now();
+    IngestResult ingest = ingestLogDumps(files, threads);
+    auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - started).count();
+    std::cout << getTimestamp() << "Scanned " << ingest.linesScanned << " lines in " << elapsedMs
+              << " ms, headers for blocks " << ingest.startBlock << " to " << ingest.endBlock
+              << ", logs from " << ingest.firstLogBlock << " to " << ingest.lastLogBlock
+              << ", found " << ingest.pools.size() << " pools" << std::endl;
+    if (ingest.malformedLogs > 0) {
+        std::cerr << getTimestamp() << "[WARN] Skipped " << ingest.malformedLogs
+                  << " malformed pool event lines" << std::endl;
+    }
+
+    bulkLoadIngestedPools(conn, ingest);
+
+    int64_t rangeStart = ingest.startBlock;
+    int64_t rangeEnd = ingest.endBlock;
+    if (fromBlock >= 0) {
+        rangeStart = fromBlock;
+        rangeEnd = toBlock;
+    } else if (rangeEnd < 0) {
+        // The first and last pool events say nothing about where the dump's range begins and ends
+        std::cout << getTimestamp() << "Dump has no block headers, keeping " << lastBlockHex
+                  << "; pass --from/--to to hand off after a logs-only dump" << std::endl;
+        return;
+    }
+    if (ingest.firstLogBlock >= 0 && (ingest.firstLogBlock < rangeStart || ingest.lastLogBlock > rangeEnd)) {
+        std::cerr << getTimestamp() << "[WARN] Dump has logs from block " << ingest.firstLogBlock
+                  << " to " << ingest.lastLogBlock << ", outside its range " << rangeStart
+                  << " to " << rangeEnd << "; keeping checkpoint " << lastBlockHex << std::endl;
+        return;
+    }
+
+    int64_t lastProcessed = std::stoll(lastBlockHex.substr(2), nullptr, 16);
+    if (rangeEnd <= lastProcessed) {
+        std::cout << getTimestamp() << "Dump ends before last block processed, keeping "
+                  << lastBlockHex << std::endl;
+    } else if (lastBlockHex != "0x0" && rangeStart > lastProcessed + 1) {
+        // Handing off here would silently skip the blocks between checkpoint and dump
+        std::cerr << getTimestamp() << "[WARN] Dump starts at block " << rangeStart
+                  << " but last block processed is " << lastBlockHex
+                  << "; keeping checkpoint so the gap is scanned over RPC" << std::endl;
+    } else {
+        advanceCheckpoint(conn, rangeEnd);
+        lastBlockHex = decimalToHex(rangeEnd);
+        std::cout << getTimestamp() << "Handing off to RPC loop after block "
+                  << lastBlockHex << std::endl;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    // token_finder [--ingest [--from <block> --to <block>] <dump files...>]
+    std::vector<std::string> ingestFiles;
+    int64_t ingestFrom = -1;
+    int64_t ingestTo = -1;
+    if (argc > 1) {
+        bool usageOk = std::string(argv[1]) == "--ingest";
+        int i = 2;
+        for (; usageOk && i + 1 < argc; i += 2) {
+            std::string arg = argv[i];
+            if (arg != "--from" && arg != "--to") {
+                break;
+            }
+            try {
+                size_t used = 0;
+                int64_t block = std::stoll(argv[i + 1], &used);
+                usageOk = used == std::strlen(argv[i + 1]) && block >= 0;
+                (arg == "--from" ? ingestFrom : ingestTo) = block;
+            } catch (const std::exception&) {
+                usageOk = false;
+            }
+        }
+        // --from and --to go together and describe a non-empty range
+        usageOk = usageOk && i < argc && std::string(argv[i]).rfind("--", 0) != 0
+                  && (ingestFrom < 0) == (ingestTo < 0) && ingestFrom <= ingestTo;
+        if (!usageOk) {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--ingest [--from <block> --to <block>] <dump.jsonl>...]" << std::endl;
+            return 1;
+        }
+        ingestFiles.assign(argv + i, argv + argc);
+    }
+
     // 1) env
     std::string dbHost = getEnvOrDefault("DB_HOST", "127.0.0.1");
     std::string dbPort = getEnvOrDefault("DB_PORT", "5432");
@@ -446,6 +1345,37 @@ int main() {
     std::string dbPass = getEnvOrDefault("DB_PASS", "test_pass");
     std::string quickNodeUrl = getEnvOrDefault("QUICKNODE_API_URL",
         "https://your-network.quiknode.pro/abcd1234/");
+    rpcMaxAttempts = (int)getEnvIntOrDefault("RPC_MAX_ATTEMPTS", 5, 1, 1000);
+    rpcBackoffBaseMs = getEnvIntOrDefault("RPC_BACKOFF_MS", 500, 1, RPC_BACKOFF_CAP_MS);
+    std::string feedSocketPath = getEnvOrDefault("FEED_SOCKET_PATH", "");
+    std::string feedShmName = getEnvOrDefault("FEED_SHM_NAME", "");
+    size_t feedCapacity = (size_t)getEnvIntOrDefault("FEED_CAPACITY", 65536, 1, INT32_MAX);
+    std::string indexSocketPath = getEnvOrDefault("INDEX_SOCKET_PATH", "");
+    bool coordinated = getEnvOrDefault("COORDINATED_MODE", "0") == "1";
+    int leaseSeconds = (int)getEnvIntOrDefault("LEASE_SECONDS", 60, 3, INT32_MAX);
+    pollInterval = std::chrono::milliseconds(getEnvIntOrDefault("POLL_INTERVAL_MS", 60000, 1));
+    // Benchmark runs stop once this block is processed and write their metrics to BENCH_REPORT
+    int64_t stopAtBlock = getEnvIntOrDefault("STOP_AT_BLOCK", -1, -1);
+    std::string benchReportPath = getEnvOrDefault("BENCH_REPORT", "");
+    char hostName[256] = "localhost";
+    gethostname(hostName, sizeof(hostName) - 1);
+    std::string instanceId = getEnvOrDefault("INSTANCE_ID",
+        (std::string(hostName) + ":" + std::to_string(getpid())).c_str());
+
+    if (coordinated && (!feedSocketPath.empty() || !feedShmName.empty() || !indexSocketPath.empty())) {
+        // Each instance only sees the pools it inserted itself, so a consumer of one instance's
+        // feed or index would silently miss everything the others find
+        std::cerr << getTimestamp() << "[ERROR] FEED_SOCKET_PATH, FEED_SHM_NAME and INDEX_SOCKET_PATH"
+                  << " can't be used with COORDINATED_MODE=1" << std::endl;
+        return 1;
+    }
+    if (coordinated && !ingestFiles.empty()) {
+        // The ingest checkpoint moves block_info outside the planning lock, and the planner
+        // and watermark would then ignore or overwrite it
+        std::cerr << getTimestamp() << "[ERROR] --ingest can't be used with COORDINATED_MODE=1;"
+                  << " ingest with a single instance first" << std::endl;
+        return 1;
+    }
 
     // connect to postgres
     std::ostringstream connStr;
@@ -462,12 +1392,54 @@ int main() {
     }
     std::cout << getTimestamp() << "Connected to Postgres." << std::endl;
 
+    if (!feedSocketPath.empty() || !feedShmName.empty()) {
+        try {
+            poolFeed.reset(new PoolFeed(feedSocketPath, feedShmName, feedCapacity));
+            std::cout << getTimestamp() << "Publishing new pools on"
+                      << (feedSocketPath.empty() ? "" : " socket " + feedSocketPath)
+                      << (feedShmName.empty() ? "" : " shm " + feedShmName) << std::endl;
+        }
+        catch (const std::exception& e) {
+            std::cerr << getTimestamp() << "[ERROR] Could not start pool feed: " << e.what() << std::endl;
+            return 1;
+        }
+    }
+
+    if (!indexSocketPath.empty()) {
+        try {
+            auto started = std::chrono::steady_clock::now();
+            poolIndex.reset(new PoolIndex());
+            loadPoolIndex(conn);
+            poolIndexServer.reset(new PoolIndexServer(*poolIndex, indexSocketPath));
+            auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - started).count();
+            std::cout << getTimestamp() << "Indexed " << poolIndex->poolCount() << " pools / "
+                      << poolIndex->tokenCount() << " tokens in " << elapsedMs
+                      << " ms, serving on " << indexSocketPath << std::endl;
+        }
+        catch (const std::exception& e) {
+            std::cerr << getTimestamp() << "[ERROR] Could not start pool index: " << e.what() << std::endl;
+            return 1;
+        }
+    }
+
     // 2) load last block
     std::string lastBlockHex = loadLastBlockProcessed(conn);
     std::cout << getTimestamp() << "Last block processed: " << lastBlockHex << std::endl;
 
-    // If "0x0", let's start 7 days ago for testing
-    if (lastBlockHex == "0x0") {
+    if (!ingestFiles.empty()) {
+        try {
+            runIngest(conn, ingestFiles, ingestFrom, ingestTo, lastBlockHex);
+        }
+        catch (const std::exception& e) {
+            std::cerr << getTimestamp() << "[ERROR] Ingest failed: " << e.what() << std::endl;
+            return 1;
+        }
+    }
+
+    // If "0x0", let's start 7 days ago for testing. Coordinated instances do this while
+    // planning work units, under the planning lock.
+    if (lastBlockHex == "0x0" && !coordinated) {
         try {
             // get current block
             json req = {
@@ -480,8 +1452,7 @@ int main() {
             std::string latestHex = resp["result"].get<std::string>();
             int64_t latestBlock = std::stoll(latestHex.substr(2), nullptr, 16);
 
-            // ~7 days => ~50400 blocks
-            int64_t sevenDaysAgo = std::max<int64_t>(0, latestBlock - 50400);
+            int64_t sevenDaysAgo = std::max<int64_t>(0, latestBlock - BOOTSTRAP_LOOKBACK_BLOCKS);
             std::string newBlockHex = decimalToHex(sevenDaysAgo);
             saveLastBlockProcessed(conn, newBlockHex);
             lastBlockHex = newBlockHex;
@@ -493,158 +1464,16 @@ int main() {
     }
 
     // 3) main loop
-    while (true) {
-        try {
-            int64_t fromBlock = std::stoll(lastBlockHex.substr(2), nullptr, 16);
-
-            // get latest
-            json req = {
-                {"jsonrpc", "2.0"},
-                {"id", 1},
-                {"method", "eth_blockNumber"},
-                {"params", json::array()}
-            };
-            json resp = quickNodeJsonRpcCall(quickNodeUrl, req);
-            std::string latestHex = resp["result"].get<std::string>();
-            int64_t latestBlock = std::stoll(latestHex.substr(2), nullptr, 16);
-
-            if (latestBlock < fromBlock) {
-                std::cout << getTimestamp() << "No new blocks to process." << std::endl;
-            } else {
-                std::cout << getTimestamp() << "Scanning from block "
-                          << fromBlock << " to " << latestBlock << std::endl;
-
-                const int64_t chunkSize = 10000;
-                int64_t currentBlock = fromBlock;
-                int64_t maxBlockProcessed = fromBlock;
-
-                while (currentBlock <= latestBlock) {
-                    int64_t endBlock = std::min(currentBlock + chunkSize, latestBlock);
-
-                    // For each DEX
-                    for (auto& dex : DEXES) {
-                        auto logs = getDexLogs(quickNodeUrl, dex, currentBlock, endBlock);
-
-                        for (auto& logEntry : logs) {
-                            std::string blockNumHex = logEntry["blockNumber"].get<std::string>();
-                            int64_t blockDec = std::stoll(blockNumHex.substr(2), nullptr, 16);
-
-                            // fetch block timestamp
-                            int64_t blockTimestampEpoch = 0;
-                            try {
-                                blockTimestampEpoch = getBlockTimestamp(quickNodeUrl, blockNumHex);
-                            } catch(...) {
-                                blockTimestampEpoch = 0; // fallback
-                            }
-
-                            auto topicsArr = logEntry["topics"];
-                            if (topicsArr.size() < 3) {
-                                continue;
-                            }
-
-                            std::string token0, token1, poolAddress;
-                            int feeValue = 0;
-                            int tickSpacing = 0;
-
-                            if (dex.isV2Style) {
-                                // PairCreated => might be 4 topics or 3
-                                if (topicsArr.size() == 4) {
-                                    // official => pair in topics[3]
-                                    token0 = topicToAddress(topicsArr[1].get<std::string>());
-                                    token1 = topicToAddress(topicsArr[2].get<std::string>());
-                                    poolAddress = topicToAddress(topicsArr[3].get<std::string>());
-                                }
-                                else if (topicsArr.size() == 3) {
-                                    // older fork => pair in data
-                                    token0 = topicToAddress(topicsArr[1].get<std::string>());
-                                    token1 = topicToAddress(topicsArr[2].get<std::string>());
-                                    std::string dataStr = logEntry["data"].get<std::string>();
-                                    if (dataStr.size() >= 66) {
-                                        poolAddress = "0x" + dataStr.substr(2, 40);
-                                    }
-                                }
-                                else {
-                                    continue;
-                                }
-                            }
-                            else {
-                                // V3 => topics[3] => fee, data => pool
-                                if (topicsArr.size() < 4) {
-                                    continue;
-                                }
-                                token0 = topicToAddress(topicsArr[1].get<std::string>());
-                                token1 = topicToAddress(topicsArr[2].get<std::string>());
-
-                                std::string feeTopic = topicsArr[3].get<std::string>();
-                                if (feeTopic.size() >= 66) {
-                                    uint64_t feeRaw = std::stoull(feeTopic.substr(2), nullptr, 16);
-                                    feeValue = (int)(feeRaw & 0xFFFFFF);
-                                }
-
-                                std::string dataStr = logEntry["data"].get<std::string>();
-                                if (dataStr.size() >= 130) {
-                                    std::string w1 = dataStr.substr(2, 64);
-                                    std::string w2 = dataStr.substr(66, 64);
-
-                                    uint64_t val1 = std::stoull(w1, nullptr, 16);
-                                    tickSpacing = (int)(val1 & 0xFFFFFF);
-
-                                    poolAddress = "0x" + w2.substr(w2.size() - 40);
-                                }
-                            }
-
-                            if (poolAddress.empty()) {
-                                continue;
-                            }
-
-                            // fetch token metadata
-                            std::string t0Symbol = getErc20Symbol(quickNodeUrl, token0);
-                            std::string t0Name   = getErc20Name(quickNodeUrl, token0);
-                            std::string t1Symbol = getErc20Symbol(quickNodeUrl, token1);
-                            std::string t1Name   = getErc20Name(quickNodeUrl, token1);
-
-                            // upsert with blockTimestamp
-                            insertLiquidityPool(
-                                conn,
-                                dex.dexName,
-                                poolAddress,
-                                token0,
-                                token1,
-                                t0Symbol,
-                                t0Name,
-                                t1Symbol,
-                                t1Name,
-                                feeValue,
-                                tickSpacing,
-                                blockNumHex,
-                                blockTimestampEpoch
-                            );
-
-                            if (blockDec > maxBlockProcessed) {
-                                maxBlockProcessed = blockDec;
-                            }
-                        }
-                    }
-
-                    if (maxBlockProcessed > fromBlock) {
-                        std::string newLastBlockHex = decimalToHex(maxBlockProcessed);
-                        saveLastBlockProcessed(conn, newLastBlockHex);
-                        lastBlockHex = newLastBlockHex;
-                        std::cout << getTimestamp() << "Updated last block to "
-                                  << newLastBlockHex << std::endl;
-                    }
-
-                    currentBlock = endBlock + 1;
-                }
-            }
-        }
-        catch (const std::exception& e) {
-            std::cerr << getTimestamp() << "[ERROR] " << e.what() << std::endl;
-        }
-
-        std::cout << getTimestamp() << "Sleeping 1 minute..." << std::endl;
-        std::this_thread::sleep_for(std::chrono::minutes(1));
+    auto loopStarted = std::chrono::steady_clock::now();
+    if (coordinated) {
+        runCoordinated(conn, connStr.str(), quickNodeUrl, instanceId, leaseSeconds, stopAtBlock);
+    } else {
+        runSingleInstance(conn, quickNodeUrl, lastBlockHex, stopAtBlock);
     }
 
+    if (!benchReportPath.empty()) {
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - loopStarted).count();
+        writeBenchReport(benchReportPath, elapsed);
+    }
     return 0;
 }